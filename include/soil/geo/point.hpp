@@ -19,7 +19,7 @@ namespace geo {
  * @tparam _dtype --- type of scalar value
  * @tparam _dimension --- space dimension, > 0
  */
-template <typename _dtype, std::size_t _dimension>
+template <typename _dtype, int _dimension>
 using Point = Eigen::Vector<_dtype, _dimension>;
 
 typedef Point<float_t, 3> FPoint3D;  /**< 3D point with float precision */
@@ -38,7 +38,7 @@ typedef Point<int64_t, 3> I64Point3D; /**< 3D point with 64bit integer */
 typedef Point<int64_t, 2> I64Point2D; /**< 2D point with 64bit integer */
 
 /** convert Point into a vector */
-template <typename _dtype, std::size_t _dimension>
+template <typename _dtype, int _dimension>
 std::vector<_dtype> to_vector(const Point<_dtype, _dimension> &point) {
     std::vector<_dtype> vec;
     vec.reserve(_dimension);
@@ -51,7 +51,7 @@ std::vector<_dtype> to_vector(const Point<_dtype, _dimension> &point) {
  *
  * The vector must have same scalar type, but can be any dimension
  */
-template <typename _dtype, std::size_t _dimension>
+template <typename _dtype, int _dimension>
 Point<_dtype, _dimension> from_vector(const std::vector<_dtype> &vec) {
     Point<_dtype, _dimension> point;
     auto itp = point.begin();
@@ -69,7 +69,7 @@ Point<_dtype, _dimension> from_vector(const std::vector<_dtype> &vec) {
  * @tparam _dtype1 --- scalar type of new point
  * @tparam _dimension --- space dimension, > 0
  */
-template <typename _dtype0, typename _dtype1, std::size_t _dimension>
+template <typename _dtype0, typename _dtype1, int _dimension>
 Point<_dtype1, _dimension> as(const Point<_dtype0, _dimension> &from) {
     Point<_dtype1, _dimension> to;
     auto itf = from.begin();
@@ -81,17 +81,18 @@ Point<_dtype1, _dimension> as(const Point<_dtype0, _dimension> &from) {
 }
 
 /** generate homogeneous point from normal one */
-template <typename _dtype, std::size_t _dimension>
+template <typename _dtype, int _dimension>
 Point<_dtype, _dimension + 1>
 to_homogeneous(const Point<_dtype, _dimension> &point) {
     return (Point<_dtype, _dimension + 1>() << point, _dtype(1)).finished();
 }
 
 /** generate normal point from homogeneous one */
-template <typename _dtype, std::size_t _dimension>
+template <typename _dtype, int _dimension>
 Point<_dtype, _dimension>
 from_homogeneous(const Point<_dtype, _dimension + 1> &homo_point) {
-    return homo_point.block<_dimension, 1>(0, 0) / homo_point[_dimension];
+    return homo_point.template block<_dimension, 1>(0, 0) /
+           homo_point[_dimension];
 }
 
 } // namespace geo
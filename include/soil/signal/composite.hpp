@@ -0,0 +1,170 @@
+#ifndef SOIL_SIGNAL_COMPOSITE_HPP
+#define SOIL_SIGNAL_COMPOSITE_HPP
+
+#include <vector>
+
+#include "soil_export.h"
+#include "soil/signal/signal.hpp"
+
+namespace soil {
+namespace signal {
+
+/**
+ * @brief Abstract signal composed of other signals
+ *
+ * A composite signal is lazy: it keeps shared pointers of its operands, so
+ * their parameters can still be changed after composition, and evaluates
+ * all of them in one pass over the referee. The referee is processed block
+ * by block, each operand fills a small buffer staying in cache, and only the
+ * output is allocated in full.
+ */
+class SOIL_EXPORT CompositeSignal : public Signal {
+public:
+    /** Get operands */
+    const std::vector<Signal_ptr> &Children() const;
+
+    std::vector<std::string> Keys() const;
+    Wavement get(const Sequence &referee) const;
+    /** Snapshots of the signal, followed by the ones of every operand */
+    SignalSnapshot SnapshotAll() const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
+
+protected:
+    /**
+     * @brief Construct a new Composite Signal object
+     *
+     * @param [in] name signal name, transferred to Signal::Signal
+     * @param [in] children operands, non-null
+     * @param [in] keys keys of composite signal
+     *
+     * @note Throw runtime error if any operand is null
+     */
+    CompositeSignal(const std::string &name,
+                    const std::vector<Signal_ptr> &children,
+                    const std::vector<std::string> &keys);
+
+    /**
+     * @brief Evaluate one block, which is small enough to stay in cache
+     *
+     * @param [in] referee block of referee
+     * @param [out] values block of output, one column per key
+     * @param [in] params snapshots of the generation, operand `i` of
+     *             `Children()` is evaluated with `params.Operand(i)`
+     */
+    virtual void evaluateBlock(ConstSequenceRef referee,
+                               Eigen::Ref<Eigen::MatrixXd> values,
+                               const SignalSnapshot &params) const = 0;
+
+private:
+    std::vector<Signal_ptr> children;
+    std::vector<std::string> keys;
+};
+
+/**
+ * @brief Column-wise sum or product of two signals
+ *
+ * Operands must have the same keys, in any order, or one of them must have a
+ * single column which is then applied to every column of the other. Keys of
+ * composite signal are the keys of the operand with more columns.
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT BinarySignal : public CompositeSignal {
+public:
+    /** operation applied on operands */
+    enum Operation { Sum, Product };
+
+    /**
+     * @brief Construct a new Binary Signal object
+     *
+     * @param [in] op operation
+     * @param [in] lhs left operand
+     * @param [in] rhs right operand
+     *
+     * @note Throw runtime error if any operand is null or their keys are not
+     *       compatible
+     */
+    BinarySignal(Operation op, const Signal_ptr &lhs, const Signal_ptr &rhs);
+
+    /** Get operation */
+    Operation BinaryOperation() const;
+
+protected:
+    void evaluateBlock(ConstSequenceRef referee,
+                       Eigen::Ref<Eigen::MatrixXd> values,
+                       const SignalSnapshot &params) const;
+
+private:
+    Operation op;
+    /** operand with more columns, evaluated into output directly */
+    bool lhs_wide;
+    /** column of narrow operand applied to each output column */
+    std::vector<Index> mapping;
+};
+
+/**
+ * @brief Signal scaled by a factor
+ *
+ * One parameter:
+ * - coeff, scale factor, type: double
+ */
+class SOIL_EXPORT ScaledSignal : public CompositeSignal {
+public:
+    /**
+     * @brief Construct a new Scaled Signal object
+     *
+     * @param [in] signal scaled signal, non-null
+     * @param [in] coeff default scale factor
+     */
+    ScaledSignal(const Signal_ptr &signal, double coeff);
+
+protected:
+    void evaluateBlock(ConstSequenceRef referee,
+                       Eigen::Ref<Eigen::MatrixXd> values,
+                       const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> coeff_id;
+};
+
+/**
+ * @brief Signal with an offset added to every column
+ *
+ * One parameter:
+ * - offset, added offset, type: double
+ */
+class SOIL_EXPORT OffsetSignal : public CompositeSignal {
+public:
+    /**
+     * @brief Construct a new Offset Signal object
+     *
+     * @param [in] signal signal to offset, non-null
+     * @param [in] offset default offset
+     */
+    OffsetSignal(const Signal_ptr &signal, double offset);
+
+protected:
+    void evaluateBlock(ConstSequenceRef referee,
+                       Eigen::Ref<Eigen::MatrixXd> values,
+                       const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> offset_id;
+};
+
+/** Compose column-wise sum of two signals, see #BinarySignal */
+Signal_ptr SOIL_EXPORT operator+(const Signal_ptr &lhs, const Signal_ptr &rhs);
+/** Compose column-wise product of two signals, see #BinarySignal */
+Signal_ptr SOIL_EXPORT operator*(const Signal_ptr &lhs, const Signal_ptr &rhs);
+/** Compose scaled signal, see #ScaledSignal */
+Signal_ptr SOIL_EXPORT operator*(double coeff, const Signal_ptr &signal);
+Signal_ptr SOIL_EXPORT operator*(const Signal_ptr &signal, double coeff);
+/** Compose signal with offset, see #OffsetSignal */
+Signal_ptr SOIL_EXPORT operator+(const Signal_ptr &signal, double offset);
+Signal_ptr SOIL_EXPORT operator+(double offset, const Signal_ptr &signal);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_COMPOSITE_HPP
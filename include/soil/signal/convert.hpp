@@ -5,6 +5,7 @@
 
 #include "soil_export.h"
 #include "soil/signal/wavement.hpp"
+#include "soil/signal/wavement_view.hpp"
 #include "soil/signal/spectrum.hpp"
 
 namespace soil {
@@ -16,8 +17,21 @@ namespace signal {
  * Convert time-domain wavement to frequency-domain spectrum.
  * Referee of input wavement must be monotonous sequence of time
  * with fixed sample rate.
+ *
+ * Samples are taken as "real + j * imag", where the real part comes from
+ * "real" column, "amp" column or the only column, and the imaginary part
+ * from "imag" column if it exists. With "imag" column, the spectrum is
+ * two-sided with zero frequency shifted to the center, i.e. frequency axis
+ * starts from `-(N / 2) * df` with `df = 1 / (N * dt)`. Without it, samples
+ * are real and a real transformation produces the non-negative half of the
+ * Hermitian spectrum, from 0 to `(N / 2) * df`, see
+ * Spectrum::HermitianCount. Values are not normalized.
+ *
+ * @return spectrum, nullopt if referee isn't uniform or no column is usable
  */
 std::optional<Spectrum> SOIL_EXPORT wavementToSpectrum(const Wavement &w);
+/** Fourier transformation reading a view over external buffers directly */
+std::optional<Spectrum> SOIL_EXPORT wavementToSpectrum(const WavementView &w);
 
 /**
  * @brief Inverse fourier transformation
@@ -25,6 +39,13 @@ std::optional<Spectrum> SOIL_EXPORT wavementToSpectrum(const Wavement &w);
  * Convert frequency-domain spectrum to time-domain wavement.
  * Frequency axis of input spectrum must be monotonous sequence
  * with fixed interval.
+ *
+ * Every point is placed on its bin of discrete fourier transformation, thus
+ * #wavementToSpectrum output is inverted exactly. The generated wavement
+ * has "real" and "imag" columns, or only "amp" column if spectrum is half of
+ * a Hermitian one. Its referee starts from 0 with interval `1 / (N * df)`.
+ *
+ * @return wavement, nullopt if frequency axis isn't uniform
  */
 std::optional<Wavement> SOIL_EXPORT spectrumToWavement(const Spectrum &spec);
 
@@ -0,0 +1,218 @@
+#ifndef SOIL_SIGNAL_FFT_HPP
+#define SOIL_SIGNAL_FFT_HPP
+
+#include <complex>
+#include <memory>
+
+#include "soil_export.h"
+#include "soil/signal/spectrum.hpp"
+
+namespace soil {
+namespace signal {
+
+class FFTPlanPriv;
+
+/**
+ * @brief Precomputed plan of fast fourier transformation
+ *
+ * A plan holds factorization, twiddle factors and Bluestein chirps of a fixed
+ * transform length and direction, so that repeated transformations pay the
+ * setup cost only once. Execution is unnormalized and thread-safe, one plan
+ * can be shared by any number of threads.
+ *
+ * Plans are normally obtained from #FFTPlanCache instead of being
+ * constructed directly.
+ */
+class SOIL_EXPORT FFTPlan {
+public:
+    /** Transform direction */
+    enum Direction {
+        Forward, /**< exp(-2 pi j k n / N) kernel */
+        Inverse  /**< exp(2 pi j k n / N) kernel, without 1/N scaling */
+    };
+
+    /**
+     * @brief Construct a new FFT Plan object
+     *
+     * @param [in] n transform length
+     * @param [in] direction transform direction
+     */
+    FFTPlan(Size n, Direction direction);
+
+    /** Destructor */
+    ~FFTPlan();
+
+    FFTPlan(const FFTPlan &) = delete;
+    FFTPlan &operator=(const FFTPlan &) = delete;
+
+    Size Length() const;                  /**< transform length */
+    Direction TransformDirection() const; /**< transform direction */
+    /** Count of complex points needed as scratch by raw `execute` */
+    Size ScratchSize() const;
+
+    /**
+     * @brief Transform in place
+     *
+     * Scratch buffer is kept per thread, so no allocation happens in steady
+     * state.
+     *
+     * @param [in,out] data sequence with `Length()` points, ignored if size
+     *                 doesn't match
+     */
+    void execute(Characteristics &data) const;
+    /**
+     * @brief Transform in place with caller-provided scratch buffer
+     *
+     * @param [in,out] data `Length()` points
+     * @param [in] scratch at least `ScratchSize()` points, must not overlap
+     *             with `data`
+     */
+    void execute(std::complex<double> *data,
+                 std::complex<double> *scratch) const;
+
+private:
+    FFTPlanPriv *priv;
+};
+
+/** Shared pointer of immutable FFT plan */
+using FFTPlan_ptr = std::shared_ptr<const FFTPlan>;
+
+class RealFFTPlanPriv;
+
+/**
+ * @brief Precomputed plan of fast fourier transformation of real signal
+ *
+ * Forward transformation maps N real points to the non-negative half of
+ * their Hermitian spectrum, i.e. `N / 2 + 1` complex points, inverse one maps
+ * them back. Even lengths are computed through a complex transformation of
+ * half length, which saves half of arithmetic and memory. Execution is
+ * unnormalized and thread-safe.
+ */
+class SOIL_EXPORT RealFFTPlan {
+public:
+    /**
+     * @brief Construct a new Real FFT Plan object
+     *
+     * @param [in] n point count of real signal
+     */
+    explicit RealFFTPlan(Size n);
+
+    /** Destructor */
+    ~RealFFTPlan();
+
+    RealFFTPlan(const RealFFTPlan &) = delete;
+    RealFFTPlan &operator=(const RealFFTPlan &) = delete;
+
+    Size Length() const;         /**< point count of real signal */
+    Size SpectrumLength() const; /**< point count of half spectrum */
+
+    /**
+     * @brief Real-to-complex transformation
+     *
+     * @param [in] x `Length()` real points
+     * @param [out] X `SpectrumLength()` complex points
+     */
+    void forward(const double *x, std::complex<double> *X) const;
+    /**
+     * @brief Complex-to-real transformation, without 1/N scaling
+     *
+     * Imaginary parts of zero and Nyquist frequencies are ignored.
+     *
+     * @param [in] X `SpectrumLength()` complex points
+     * @param [out] x `Length()` real points
+     */
+    void inverse(const std::complex<double> *X, double *x) const;
+
+private:
+    RealFFTPlanPriv *priv;
+};
+
+/** Shared pointer of immutable real FFT plan */
+using RealFFTPlan_ptr = std::shared_ptr<const RealFFTPlan>;
+
+/**
+ * @brief Process-wide cache of FFT plans keyed by length and direction
+ *
+ * All methods are thread-safe. A plan is built at the first request of its
+ * length and direction, and shared by all later requests. Real plans are
+ * cached by length separately.
+ *
+ * At most #CAPACITY plans of each kind are kept, the least recently
+ * requested one is dropped to make room for a new one, so that processes
+ * meeting many lengths don't grow without bound.
+ */
+class SOIL_EXPORT FFTPlanCache {
+public:
+    /** maximum count of cached complex plans, and of cached real plans */
+    static constexpr Size CAPACITY = 64;
+
+    /**
+     * @brief Get the plan of given length and direction
+     *
+     * @param [in] n transform length
+     * @param [in] direction transform direction
+     * @return shared plan, never null
+     */
+    static FFTPlan_ptr get(Size n, FFTPlan::Direction direction);
+    /**
+     * @brief Get the real plan of given length
+     *
+     * @param [in] n point count of real signal
+     * @return shared plan, never null
+     */
+    static RealFFTPlan_ptr getReal(Size n);
+    /** Count of cached plans */
+    static Size Count();
+    /** Drop all cached plans, plans in use stay alive until released */
+    static void clear();
+};
+
+/**
+ * @brief Fast fourier transformation of a complex sequence
+ *
+ * X[k] = sum(x[n] * exp(-2 pi j k n / N)), without normalization.
+ * Any length is supported: lengths composed of small prime factors use a
+ * mixed-radix algorithm, others use Bluestein's algorithm, both O(N log N).
+ * The plan is taken from #FFTPlanCache.
+ *
+ * @param [in] x input sequence
+ * @return spectrum sequence with the same size
+ */
+Characteristics SOIL_EXPORT fft(const Characteristics &x);
+
+/**
+ * @brief Inverse fast fourier transformation of a complex sequence
+ *
+ * x[n] = sum(X[k] * exp(2 pi j k n / N)) / N, which means
+ * `ifft(fft(x))` reproduces `x`.
+ *
+ * @param [in] X input spectrum sequence
+ * @return sequence with the same size
+ */
+Characteristics SOIL_EXPORT ifft(const Characteristics &X);
+
+/**
+ * @brief Fast fourier transformation of a real sequence
+ *
+ * Same as the first `N / 2 + 1` points of #fft on real input.
+ *
+ * @param [in] x input sequence
+ * @return non-negative half of spectrum
+ */
+Characteristics SOIL_EXPORT rfft(const Sequence &x);
+
+/**
+ * @brief Inverse fast fourier transformation to a real sequence
+ *
+ * `irfft(rfft(x), x.size())` reproduces `x`.
+ *
+ * @param [in] X non-negative half of spectrum, `n / 2 + 1` points
+ * @param [in] n point count of real sequence
+ * @return real sequence, empty if sizes don't match
+ */
+Sequence SOIL_EXPORT irfft(const Characteristics &X, Size n);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_FFT_HPP
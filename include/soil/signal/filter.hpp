@@ -0,0 +1,112 @@
+#ifndef SOIL_SIGNAL_FILTER_HPP
+#define SOIL_SIGNAL_FILTER_HPP
+
+#include "Eigen/Dense"
+#include "soil_export.h"
+#include "soil/signal/processor.hpp"
+
+namespace soil {
+namespace signal {
+
+class FIRFilterPriv;
+
+/**
+ * @brief Channel filtering every column by a finite impulse response
+ *
+ * Output is `y[n] = sum(taps[k] * x[n - k])`, with samples before the first
+ * one taken as zeros. All columns are filtered at once: every tap adds a
+ * scaled block of input to a block of output, which stays in cache and is
+ * vectorized across rows and columns.
+ *
+ * Consecutive blocks of a stream are filtered by `feed`, which keeps the last
+ * `taps - 1` samples of every column. Filter state is reset whenever keys of
+ * fed blocks change.
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT FIRFilter : public Channel {
+public:
+    /**
+     * @brief Construct a new FIR Filter object
+     *
+     * @param [in] taps coefficients of impulse response
+     *
+     * @note Throw runtime error if taps are empty
+     */
+    explicit FIRFilter(const Sequence &taps);
+    /** Destructor */
+    ~FIRFilter();
+
+    /** Get coefficients of impulse response */
+    const Sequence &Taps() const;
+
+    /**
+     * @brief Filter next block of stream
+     *
+     * @param [in] block next block of stream
+     * @return filtered block, with referee of input
+     */
+    Wavement feed(const Wavement &block);
+    /** Clear filter state, as if no block has been fed */
+    void reset();
+
+    /** Filter a whole wavement with a fresh filter state */
+    Wavement via(const Wavement &w) const;
+    void process(Wavement &w) const;
+
+private:
+    FIRFilterPriv *priv;
+};
+
+class BiquadFilterPriv;
+
+/**
+ * @brief Channel filtering every column by a cascade of second-order
+ *        sections of infinite impulse response
+ *
+ * Every section is given as `[b0, b1, b2, a0, a1, a2]`, i.e. transfer function
+ * `(b0 + b1 z^-1 + b2 z^-2) / (a0 + a1 z^-1 + a2 z^-2)`, the same layout as
+ * `sos` arrays of SciPy. Sections are applied in transposed direct form II,
+ * all of them in one pass over samples. Columns are filtered 4 at a time so
+ * that their independent recursions run side by side.
+ *
+ * Consecutive blocks of a stream are filtered by `feed`, which keeps 2 state
+ * values per section and column. Filter state is reset whenever keys of fed
+ * blocks change.
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT BiquadFilter : public Channel {
+public:
+    /**
+     * @brief Construct a new Biquad Filter object
+     *
+     * @param [in] sos one row per section, 6 columns
+     *
+     * @note Throw runtime error if there's no section, count of columns
+     *       isn't 6 or any `a0` is 0
+     */
+    explicit BiquadFilter(const Eigen::MatrixXd &sos);
+    /** Destructor */
+    ~BiquadFilter();
+
+    /** Get count of sections */
+    Size SectionCount() const;
+
+    /** Filter next block of stream, see #FIRFilter::feed */
+    Wavement feed(const Wavement &block);
+    /** Clear filter state, as if no block has been fed */
+    void reset();
+
+    /** Filter a whole wavement with a fresh filter state */
+    Wavement via(const Wavement &w) const;
+    void process(Wavement &w) const;
+
+private:
+    BiquadFilterPriv *priv;
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_FILTER_HPP
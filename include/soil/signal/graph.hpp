@@ -0,0 +1,95 @@
+#ifndef SOIL_SIGNAL_GRAPH_HPP
+#define SOIL_SIGNAL_GRAPH_HPP
+
+#include <functional>
+#include <vector>
+
+#include "soil_export.h"
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/signal/wavement.hpp"
+
+namespace soil {
+namespace signal {
+
+class GraphPriv;
+
+/**
+ * @brief Dataflow graph of signals and processors
+ *
+ * Every node produces one wavement: a signal node generates it on a referee,
+ * a processor node processes the output of another node, and a custom node
+ * combines outputs of any number of nodes, e.g. for analysis. A node can
+ * only take outputs of nodes added before it, so the graph never has cycle.
+ *
+ * `run` executes nodes on the library pool, see util::TaskGroup: each node
+ * is spawned as soon as all its inputs are ready, so that independent
+ * branches run concurrently, and chunk-level loops inside nodes share the
+ * same workers.
+ */
+class SOIL_EXPORT Graph {
+public:
+    /** function of custom node, taking outputs of its inputs in order */
+    using NODE_FUNC =
+        std::function<Wavement(const std::vector<const Wavement *> &)>;
+
+    /** Construct an empty graph */
+    Graph();
+    /** Destructor */
+    ~Graph();
+
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+
+    /**
+     * @brief Add a node generating a signal
+     *
+     * @param [in] signal signal, shared so its parameters can still be changed
+     * @param [in] referee referee of generated wavement
+     * @return index of node, -1 if signal is null
+     */
+    int addSignal(const Signal_ptr &signal, const Sequence &referee);
+    /**
+     * @brief Add a node processing output of another node
+     *
+     * @param [in] processor processor, shared as well
+     * @param [in] input index of input node
+     * @return index of node, -1 if processor is null or input is invalid
+     */
+    int addProcessor(const Processor_ptr &processor, int input);
+    /**
+     * @brief Add a custom node combining outputs of other nodes
+     *
+     * @param [in] func function computing output, called from any thread
+     * @param [in] inputs indexes of input nodes
+     * @return index of node, -1 if function is empty or any input is invalid
+     */
+    int addNode(const NODE_FUNC &func, const std::vector<int> &inputs);
+
+    /** Get count of nodes */
+    int NodeCount() const;
+
+    /**
+     * @brief Execute all nodes
+     *
+     * @note The first exception thrown by a node is rethrown after all
+     *       running nodes finish, nodes depending on a failed one are skipped
+     */
+    void run();
+    /**
+     * @brief Get output of a node after `run`
+     *
+     * @param [in] node index of node
+     * @return output wavement, empty wavement if index is invalid or node
+     *         isn't executed
+     */
+    const Wavement &Output(int node) const;
+
+private:
+    GraphPriv *priv;
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_GRAPH_HPP
@@ -1,8 +1,12 @@
 #ifndef SOIL_SIGNAL_PROCESSOR_HPP
 #define SOIL_SIGNAL_PROCESSOR_HPP
 
+#include <memory>
+#include <vector>
+
 #include "soil_export.h"
 #include "soil/signal/wavement.hpp"
+#include "soil/signal/wavement_view.hpp"
 #include "soil/util/parameterized.hpp"
 
 namespace soil {
@@ -27,11 +31,42 @@ public:
      * @return wavement after precession
      */
     virtual Wavement via(const Wavement &w) const = 0;
+    /**
+     * @brief process a view over external buffers
+     *
+     * The default implementation copies the view into a wavement and calls
+     * `via(const Wavement &)`, subclasses can override it to read the view
+     * directly.
+     *
+     * @param [in] w input view
+     * @return wavement after precession
+     */
+    virtual Wavement viaView(const WavementView &w) const;
+    /**
+     * @brief process a wavement taken by value, reusing its storage
+     *
+     * @param [in] w input wavement, moved into output
+     * @return wavement after precession
+     */
+    Wavement viaMoved(Wavement &&w) const;
+    /**
+     * @brief process a wavement in place
+     *
+     * The default implementation replaces the wavement by the output of
+     * `via(const Wavement &)`, subclasses whose output has the same layout
+     * as input can override it to avoid any allocation.
+     *
+     * @param [in,out] w wavement to process
+     */
+    virtual void process(Wavement &w) const;
 
 protected:
     explicit Processor(const std::string &name);
 };
 
+/** shared pointer of processor */
+using Processor_ptr = std::shared_ptr<Processor>;
+
 /** Define abstract signal channel by using #Processor directly */
 using Channel = Processor;
 
@@ -40,18 +75,35 @@ class SOIL_EXPORT IdealChannel : public Channel {
 public:
     explicit IdealChannel();
     Wavement via(const Wavement &w) const;
+    Wavement viaView(const WavementView &w) const;
+    void process(Wavement &w) const;
 };
 
 /**
  * @brief Channel with linear transformation
  *
- * 3 additional parameters:
- * - delay, shift on referee
+ * 4 additional parameters:
+ * - delay, delay of wavement
  * - coeff, coefficient on values
  * - offset, offset on values
+ * - delay_mode, how delay is applied, type: std::string
+ *
+ * After process, every value becomes "value * coeff + offset", and the delay
+ * is applied according to delay_mode:
+ * - "referee", every referee becomes "referee + delay", samples are kept
+ * - "grid", referee is kept and samples are moved along it, the integer part
+ *   of delay in samples is an offset copy, the fractional part is a cubic
+ *   Lagrange interpolator
+ * - "spectral", referee is kept and samples are moved by a linear phase ramp
+ *   on the zero-padded spectrum, i.e. band-limited interpolation
  *
- * After process, every referee becomes "referee + delay", every value
- * becomes "value * coeff + offset"
+ * Samples moved in from outside of wavement are zero. The last two modes
+ * need a uniform and increasing referee, whose points are within the
+ * tolerance of an evenly spaced grid, and a wavement with less than 2 points
+ * is processed in "referee" mode.
+ *
+ * @note `via` and `process` throw runtime error if referee isn't uniform in
+ *       "grid" or "spectral" mode, the wavement is then kept unchanged
  */
 class SOIL_EXPORT LinearChannel : public Channel {
 public:
@@ -61,10 +113,59 @@ public:
      * @param [in] delay default referee delay
      * @param [in] coeff default coefficient on values
      * @param [in] offset default offset on values
+     * @param [in] delay_mode default delay mode
+     *
+     * @note Throw runtime error if delay mode is invalid
      */
     explicit LinearChannel(double delay = 0.0, double coeff = 1.0,
-                           double offset = 0.0);
+                           double offset = 0.0,
+                           const std::string &delay_mode = "referee");
     Wavement via(const Wavement &w) const;
+    Wavement viaView(const WavementView &w) const;
+    void process(Wavement &w) const;
+
+protected:
+    bool checkParameter(const std::string &name, const std::any &current,
+                        const std::any &next) const;
+
+private:
+    util::ParamId<double> delay_id, coeff_id, offset_id;
+    util::ParamId<std::string> delay_mode_id;
+};
+
+class ProcessorChainPriv;
+
+/**
+ * @brief Chain of processors applied one after another
+ *
+ * A wavement is copied once and then processed in place by every processor,
+ * so a chain of processors supporting in-place process reuses one buffer.
+ * Processors are shared, their parameters can still be changed.
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT ProcessorChain : public Processor {
+public:
+    /**
+     * @brief Construct a new Processor Chain object
+     *
+     * @param [in] processors processors in order of application, null ones
+     *             are ignored
+     */
+    explicit ProcessorChain(const std::vector<Processor_ptr> &processors = {});
+    /** Destructor */
+    ~ProcessorChain();
+
+    /** Append a processor at the end, ignored if null */
+    void append(const Processor_ptr &processor);
+    /** Get processors in order of application */
+    std::vector<Processor_ptr> Processors() const;
+
+    Wavement via(const Wavement &w) const;
+    void process(Wavement &w) const;
+
+private:
+    ProcessorChainPriv *priv;
 };
 
 } // namespace signal
@@ -0,0 +1,149 @@
+#ifndef SOIL_SIGNAL_RESAMPLER_HPP
+#define SOIL_SIGNAL_RESAMPLER_HPP
+
+#include "soil_export.h"
+#include "soil/signal/processor.hpp"
+
+namespace soil {
+namespace signal {
+
+class ResamplerPriv;
+
+/**
+ * @brief Abstract processor converting sample rate of uniform wavements
+ *
+ * Every output sample is the product of a window of `2 * half_taps` input
+ * samples with one row of a precomputed bank of filter phases, a Kaiser
+ * windowed sinc low-pass whose cutoff is `cutoff` times the lower Nyquist
+ * frequency of input and output, so that upsampling, filtering and
+ * downsampling happen in one pass. Every row is normalized to unit DC gain.
+ * Samples out of input are taken as zeros.
+ *
+ * Output referee starts at the first input point and covers the input
+ * span with the output interval. A wavement of less than 2 points is
+ * returned unchanged.
+ *
+ * Consecutive blocks of a stream are resampled by `feed`, which keeps the
+ * input samples still read by windows of coming output samples. An output
+ * sample is returned once its whole window is fed, so that output lags by
+ * `half_taps` input samples, and concatenated outputs match `via` of
+ * concatenated blocks but for the last samples. Stream is restarted
+ * whenever keys of fed blocks change. Blocks of a real-time stream stay in
+ * cache, while `via` of a whole capture is bound by memory.
+ *
+ * Blocks of output samples and columns are computed in parallel, every
+ * block copies only the input samples it reads into a scratch of its
+ * thread, windows of 8, 16 or 32 taps are unrolled at compile time, and
+ * windows of multiples of 8 taps use AVX-512, or AVX2 and FMA, where
+ * available.
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT Resampler : public Processor {
+public:
+    /** Destructor */
+    ~Resampler();
+
+    /** Get ratio of output rate to input rate */
+    double Ratio() const;
+    /** Get count of input samples contributing to one output sample */
+    Size Taps() const;
+
+    /**
+     * @brief Resample next block of stream
+     *
+     * Output referee continues the one of the first block of stream, with
+     * the output interval.
+     *
+     * @param [in] block next block of stream
+     * @return output samples whose windows are fed, possibly none
+     * @note Throw runtime error if referee of `block` isn't uniform or has
+     *       less than 2 points
+     */
+    Wavement feed(const Wavement &block);
+    /** Clear stream state, as if no block has been fed */
+    void reset();
+
+    /**
+     * @brief Resample a whole wavement, out of any stream
+     *
+     * @param [in] w wavement to resample
+     * @return Wavement resampled wavement
+     * @note Throw runtime error if referee of `w` isn't uniform
+     */
+    Wavement via(const Wavement &w) const;
+
+protected:
+    /**
+     * @brief Construct a new Resampler object
+     *
+     * Output sample `j` is at input position `j * step / phases`, so the
+     * ratio of rates is `phases / step`.
+     *
+     * @param [in] name name passed to #soil::util::Parameterized
+     * @param [in] phases count of phases between input samples, >0, and a
+     *             power of 2 if not exact
+     * @param [in] step step of output samples in phases, >0
+     * @param [in] exact whether step is an integer, so that every output
+     *             falls on a phase, otherwise adjacent phases are
+     *             interpolated linearly
+     * @param [in] half_taps half count of taps, >0
+     * @param [in] cutoff cutoff relative to lower Nyquist frequency, in
+     *             `(0, 1]`
+     *
+     * @note Throw runtime error if any setting is invalid
+     */
+    Resampler(const std::string &name, Size phases, double step, bool exact,
+              Size half_taps, double cutoff);
+
+private:
+    ResamplerPriv *priv;
+};
+
+/**
+ * @brief Resampler with rational ratio `up / down`
+ *
+ * Output samples fall exactly on the `up` phases of filter bank, e.g.
+ * `RationalResampler(3, 2)` turns 100MS/s into 150MS/s.
+ */
+class SOIL_EXPORT RationalResampler : public Resampler {
+public:
+    /**
+     * @brief Construct a new Rational Resampler object
+     *
+     * @param [in] up upsampling factor, >0
+     * @param [in] down downsampling factor, >0
+     * @param [in] half_taps half count of taps, >0
+     * @param [in] cutoff cutoff relative to lower Nyquist frequency
+     *
+     * @note Throw runtime error if any setting is invalid
+     */
+    RationalResampler(Size up, Size down, Size half_taps = 8,
+                      double cutoff = 0.9);
+};
+
+/**
+ * @brief Resampler with arbitrary ratio
+ *
+ * Windowed sinc is tabulated on 512 phases between input samples, and
+ * interpolated linearly between adjacent phases.
+ */
+class SOIL_EXPORT ArbitraryResampler : public Resampler {
+public:
+    /**
+     * @brief Construct a new Arbitrary Resampler object
+     *
+     * @param [in] ratio ratio of output rate to input rate, >0
+     * @param [in] half_taps half count of taps, >0
+     * @param [in] cutoff cutoff relative to lower Nyquist frequency
+     *
+     * @note Throw runtime error if any setting is invalid
+     */
+    explicit ArbitraryResampler(double ratio, Size half_taps = 8,
+                                double cutoff = 0.9);
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_RESAMPLER_HPP
@@ -2,16 +2,48 @@
 #define SOIL_SIGNAL_SIGNAL_HPP
 
 #include <any>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "soil_export.h"
 #include "soil/util/parameterized.hpp"
 #include "soil/signal/wavement.hpp"
+#include "soil/signal/wavement_view.hpp"
 
 namespace soil {
 namespace signal {
 
+/**
+ * @brief Parameters of a signal and of all its operands, pinned together
+ *
+ * A generation takes one by `Signal::SnapshotAll` before evaluating any
+ * block and passes it to every `evaluate` call, so that all blocks of a
+ * wavement see the same parameter values even if they are set concurrently.
+ */
+class SOIL_EXPORT SignalSnapshot {
+public:
+    /**
+     * @brief Construct a new Signal Snapshot object
+     *
+     * @param [in] own snapshot of the signal itself
+     * @param [in] operands snapshots of operands, in the order of operands
+     */
+    explicit SignalSnapshot(util::ParameterSnapshot &&own,
+                            std::vector<SignalSnapshot> &&operands = {});
+    /** Move constructor */
+    SignalSnapshot(SignalSnapshot &&other) = default;
+
+    /** Get snapshot of the signal itself */
+    const util::ParameterSnapshot &Own() const;
+    /** Get snapshots of operand with given index, see #CompositeSignal */
+    const SignalSnapshot &Operand(Index index) const;
+
+private:
+    util::ParameterSnapshot own;
+    std::vector<SignalSnapshot> operands;
+};
+
 /**
  * @brief Abstract signal interface
  *
@@ -42,12 +74,57 @@ public:
     virtual std::vector<std::string> Keys() const = 0;
     /** Generate a wavement according to given referee */
     virtual Wavement get(const Sequence &referee) const = 0;
+    /**
+     * @brief Generate a wavement on referee of a view
+     *
+     * Only referee of the view is used, values of it are ignored. It's named
+     * differently from `get`, so that overriding `get` in derived classes
+     * never hides it.
+     */
+    Wavement getOn(const WavementView &view) const;
+    /**
+     * @brief Take snapshots of parameters of the signal and its operands
+     *
+     * The default implementation pins parameters of the signal itself,
+     * signals with operands add the ones of their operands.
+     */
+    virtual SignalSnapshot SnapshotAll() const;
+    /**
+     * @brief Fill values of all columns on a block of referee
+     *
+     * It's used by composite signals to evaluate operands block by block
+     * without any intermediate wavement. Parameters must be read from
+     * `params` rather than from the signal, so that all blocks of one
+     * generation are consistent. The default implementation copies from
+     * `get`, which takes its own snapshot, subclasses can override it to
+     * write values directly. Blocks may be evaluated concurrently, see
+     * #soil::util::parallelFor.
+     *
+     * @param [in] referee block of referee
+     * @param [out] values matrix with one column per key, in the order of
+     *              `Keys()`, and one row per referee point
+     * @param [in] params snapshots taken by `SnapshotAll` for the whole
+     *             generation
+     */
+    virtual void evaluate(ConstSequenceRef referee,
+                          Eigen::Ref<Eigen::MatrixXd> values,
+                          const SignalSnapshot &params) const;
 
 protected:
     /** Constructor with name assigning */
     explicit Signal(const std::string &name);
+
+    /**
+     * @brief Generate a wavement by `evaluate`, allocating values only once
+     *
+     * Parameters are pinned once by `SnapshotAll` for all blocks.
+     */
+    Wavement generate(const Sequence &referee) const;
 };
 
+/** shared pointer of signal */
+using Signal_ptr = std::shared_ptr<Signal>;
+
 class FunctionalSignalPriv;
 
 /**
@@ -55,15 +132,23 @@ class FunctionalSignalPriv;
  *
  * It can wrap any number of signal functions via constructor.
  * Signal function receives only one double argument as referee and returns
- * a double value as signal amplitude.
+ * a double value as signal amplitude. A block function receives the whole
+ * referee and fills a column of the same size at once, so that it can be
+ * written with Eigen array expressions instead of being called per point.
  * Each function corresponds a non-empty key.
  *
+ * Functions are called concurrently on different blocks of referee if the
+ * library uses more than one thread, see #soil::util::setThreadCount.
+ *
  * No valid parameter.
  */
 class SOIL_EXPORT FunctionalSignal : public Signal {
 public:
     /** signal function */
     typedef std::function<double(double)> SIG_FUNC;
+    /** block signal function, filling values of all referee points */
+    typedef std::function<void(const Sequence &, Eigen::Ref<Sequence>)>
+        BLOCK_FUNC;
 
     /**
      * @brief Construct a new Functional Signal object
@@ -72,12 +157,21 @@ public:
      */
     explicit FunctionalSignal(
         const std::unordered_map<std::string, SIG_FUNC> &functions);
+    /**
+     * @brief Construct a new Functional Signal object with block functions
+     *
+     * @param [in] functions map of block signal function and its key
+     */
+    explicit FunctionalSignal(
+        const std::unordered_map<std::string, BLOCK_FUNC> &functions);
 
     /** Destructor */
     ~FunctionalSignal();
 
     std::vector<std::string> Keys() const;
     Wavement get(const Sequence &referee) const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
 
 private:
     FunctionalSignalPriv *priv;
@@ -100,6 +194,11 @@ public:
 
     std::vector<std::string> Keys() const;
     Wavement get(const Sequence &referee) const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> level_id;
 };
 
 /**
@@ -123,6 +222,11 @@ public:
 
     std::vector<std::string> Keys() const;
     Wavement get(const Sequence &referee) const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> coeff_id, offset_id;
 };
 
 /** Abstract periodical signal with 'freq' parameter (unit: Hz) */
@@ -135,6 +239,8 @@ protected:
      * @param [in] freq default frequency
      */
     explicit PeriodicalSignal(const std::string &name, double freq);
+
+    util::ParamId<double> freq_id; /**< handle of 'freq' parameter */
 };
 
 /**
@@ -162,6 +268,11 @@ public:
 
     std::vector<std::string> Keys() const;
     Wavement get(const Sequence &referee) const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> phase_id, A_id, offset_id;
 };
 
 /**
@@ -190,6 +301,11 @@ public:
 
     std::vector<std::string> Keys() const;
     Wavement get(const Sequence &referee) const;
+    void evaluate(ConstSequenceRef referee, Eigen::Ref<Eigen::MatrixXd> values,
+                  const SignalSnapshot &params) const;
+
+private:
+    util::ParamId<double> phase_id, A_id;
 };
 
 /**
@@ -216,6 +332,9 @@ protected:
     virtual bool checkParameter(const std::string &name,
                                 const std::any &current,
                                 const std::any &next) const;
+
+    util::ParamId<double> begin_id;    /**< handle of 'begin' parameter */
+    util::ParamId<double> duration_id; /**< handle of 'duration' parameter */
 };
 
 } // namespace signal
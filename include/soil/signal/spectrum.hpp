@@ -1,6 +1,8 @@
 #ifndef SOIL_SIGNAL_SPECTRUM_HPP
 #define SOIL_SIGNAL_SPECTRUM_HPP
 
+#include <optional>
+
 #include "Eigen/Dense"
 #include "soil_export.h"
 #include "soil/signal/wavement.hpp"
@@ -17,6 +19,15 @@ class SpectrumPriv;
  * @brief Frequency spectrum
  *
  * Frenquency axis is a double vector, value axis is a complex vector.
+ *
+ * A spectrum can also be the non-negative half of the Hermitian spectrum of
+ * a real signal, where negative frequencies are implied by conjugate
+ * symmetry. In this case `HermitianCount()` tells the point count of the real
+ * signal, and the spectrum holds `HermitianCount() / 2 + 1` points.
+ *
+ * A uniform frequency axis is held implicitly as a #UniformGrid, like the
+ * referee of #Wavement: it's only materialized when `Frenquencies()` is
+ * first called, and bins are located by O(1) arithmetic.
  */
 class SOIL_EXPORT Spectrum {
 public:
@@ -25,23 +36,31 @@ public:
      *
      * @param [in] freq frequency axis
      * @param [in] values value axis
+     * @param [in] hermitian point count of real signal if spectrum is the
+     *             half of its Hermitian spectrum, 0 for a full spectrum
      *
-     * @note Throw runtime error if point count is less than 2 or sizes of two
-     *       axes don't match.
+     * @note Throw runtime error if point count is less than 2, sizes of two
+     *       axes don't match or `hermitian` doesn't match point count.
      */
-    Spectrum(const Sequence &freq, const Characteristics &values);
-    Spectrum(Sequence &&freq, Characteristics &&values);
+    Spectrum(const Sequence &freq, const Characteristics &values,
+             Size hermitian = 0);
+    Spectrum(Sequence &&freq, Characteristics &&values, Size hermitian = 0);
     /**
      * @brief Construct a new Spectrum object
      *
      * @param [in] f0 beginning of frequency axis, unit: Hz
      * @param [in] f_step frequency step, unit: Hz
      * @param [in] values value axis
+     * @param [in] hermitian point count of real signal if spectrum is the
+     *             half of its Hermitian spectrum, 0 for a full spectrum
      *
-     * @note Throw runtime error if size of value axis is less than 2
+     * @note Throw runtime error if size of value axis is less than 2 or
+     *       `hermitian` doesn't match it
      */
-    Spectrum(double f0, double f_step, const Characteristics &values);
-    Spectrum(double f0, double f_step, Characteristics &&values);
+    Spectrum(double f0, double f_step, const Characteristics &values,
+             Size hermitian = 0);
+    Spectrum(double f0, double f_step, Characteristics &&values,
+             Size hermitian = 0);
 
     /** Copy constructor */
     Spectrum(const Spectrum &other);
@@ -59,6 +78,21 @@ public:
     Size Count() const;                    /**< point count */
     const Sequence &Frenquencies() const;  /**< frequency axis */
     const Characteristics &Values() const; /**< value axis */
+    /** Get writable value axis, size can't be changed through it */
+    Eigen::Ref<Characteristics> MutableValues();
+    /** Get uniform grid of frequency axis, nullopt if it isn't uniform */
+    std::optional<UniformGrid> Grid() const;
+    /** Get frequency at given index, NaN if index is invalid */
+    double FrequencyAt(Index index) const;
+    /**
+     * @brief Get index of the bin nearest to given frequency
+     *
+     * It's O(1) for uniform axis, otherwise the axis must be increasing and
+     * it's searched by bisection.
+     */
+    Index NearestIndex(double freq) const;
+    /** point count of real signal for half spectrum, 0 for full spectrum */
+    Size HermitianCount() const;
 
 private:
     SpectrumPriv *priv;
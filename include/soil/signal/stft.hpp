@@ -0,0 +1,119 @@
+#ifndef SOIL_SIGNAL_STFT_HPP
+#define SOIL_SIGNAL_STFT_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "soil_export.h"
+#include "soil/signal/spectrum.hpp"
+#include "soil/signal/wavement.hpp"
+#include "soil/signal/window.hpp"
+
+namespace soil {
+namespace signal {
+
+/** Spectra of successive frames of a column, sharing one frequency axis */
+struct SOIL_EXPORT Spectrogram {
+    UniformGrid times;       /**< referee at the first point of every frame */
+    UniformGrid frequencies; /**< frequency of every bin, from 0, unit: Hz */
+    Size fft_size;           /**< point count of every transformation */
+    /** values, one column per frame and one row per frequency */
+    Eigen::MatrixXcd values;
+
+    /**
+     * @brief Get spectrum of one frame, as half of a Hermitian spectrum
+     *
+     * @param [in] frame frame index
+     * @return spectrum, nullopt if index is invalid
+     */
+    std::optional<Spectrum> SpectrumAt(Index frame) const;
+    /** Get spectra of all frames */
+    std::vector<Spectrum> Spectra() const;
+};
+
+/**
+ * @brief One-sided power spectral density of a real column
+ *
+ * Power of negative frequencies is folded onto positive ones, so the sum of
+ * values times frequency step estimates the mean power of the column.
+ */
+struct PowerSpectralDensity {
+    UniformGrid frequencies; /**< frequency of every bin, from 0 to Nyquist */
+    Sequence values; /**< density of every bin, unit: squared value per Hz */
+};
+
+/**
+ * @brief Short-time fourier transformation of a real column
+ *
+ * Frames of `frame` points start every `hop` points, every frame is
+ * multiplied by the periodic coefficients of window, see
+ * Window::Coefficients, zero-padded to `fft_size` points and transformed by
+ * a real FFT. Values are not normalized, a frame equals #rfft of the
+ * windowed and padded points. Trailing points not filling a whole frame are
+ * ignored.
+ *
+ * Frames are split over the thread pool and share one cached plan, every
+ * task pads frames in a scratch buffer of its thread, results never depend
+ * on the thread count.
+ */
+class SOIL_EXPORT STFT {
+public:
+    /**
+     * @brief Construct a new STFT object
+     *
+     * @param [in] window window of frames, null for a rectangular one
+     * @param [in] frame point count of a frame, >1
+     * @param [in] hop points between beginnings of frames, >0
+     * @param [in] fft_size point count of transformation, not less than
+     *             `frame`, 0 for `frame`
+     *
+     * @note Throw runtime error if any size is invalid
+     */
+    STFT(const std::shared_ptr<const Window> &window, Size frame, Size hop,
+         Size fft_size = 0);
+
+    Size Frame() const;   /**< point count of a frame */
+    Size Hop() const;     /**< points between beginnings of frames */
+    Size FFTSize() const; /**< point count of transformation */
+
+    /**
+     * @brief Transform every frame of a column
+     *
+     * @param [in] w input wavement, its referee must be uniform
+     * @param [in] key key of column
+     * @return spectrogram, nullopt if referee isn't uniform, column
+     *         non-exists or there is no whole frame
+     */
+    std::optional<Spectrogram> analyze(const Wavement &w,
+                                       const std::string &key) const;
+    /**
+     * @brief Estimate power spectral density by Welch's method
+     *
+     * Squared magnitudes of all frames are averaged, and scaled by `1 / (fs
+     * * sum(window^2))` as a one-sided density, where `fs` is sample rate.
+     * Frames are not detrended. Unlike #analyze, no spectrogram is kept:
+     * frames are summed into a fixed number of partial sums, each one over a
+     * fixed range of frames, which are then added in order. So memory
+     * doesn't grow with the length of column, and results don't depend on
+     * the thread count.
+     *
+     * @param [in] w input wavement, its referee must be uniform
+     * @param [in] key key of column
+     * @return density from 0 to Nyquist frequency, nullopt in the same cases
+     *         as #analyze
+     */
+    std::optional<PowerSpectralDensity> welch(const Wavement &w,
+                                              const std::string &key) const;
+
+private:
+    std::shared_ptr<const Window> window;
+    Size frame, hop, fft_size;
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_STFT_HPP
@@ -0,0 +1,164 @@
+#ifndef SOIL_SIGNAL_STORAGE_HPP
+#define SOIL_SIGNAL_STORAGE_HPP
+
+#include <any>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Eigen/Dense"
+#include "soil_export.h"
+#include "soil/signal/spectrum.hpp"
+#include "soil/signal/wavement.hpp"
+#include "soil/signal/wavement_view.hpp"
+#include "soil/util/parameterized.hpp"
+
+/*
+ * Binary files of wavements and spectrums
+ *
+ * A file starts with a 64-byte header (magic `SOILDATA`, format version, kind
+ * and counts), followed by the columns in native byte order, each starting
+ * at a 64-byte boundary, and ends with a directory of column keys and the
+ * metadata of a parameterized object. Wavement files hold the referee and
+ * every value column, spectrum files hold the frequency axis and the complex
+ * values as interleaved real and imaginary parts.
+ *
+ * Loaded files are mapped into memory, so opening is independent of file size
+ * and only the touched columns are read from disk.
+ */
+
+namespace soil {
+namespace signal {
+
+/** version of binary format written by this library */
+constexpr unsigned STORAGE_VERSION = 1;
+
+/**
+ * @brief Metadata of a parameterized object stored with data
+ *
+ * Only parameters of type double, int, bool, #Size, std::string and
+ * std::complex<double> are stored, others are skipped silently.
+ */
+struct SOIL_EXPORT StoredMetadata {
+    std::string name; /**< name of the object, empty if not stored */
+    std::unordered_map<std::string, std::any> parameters;
+
+    /**
+     * @brief Set stored parameters to an object
+     *
+     * @param [in] target object to set, usually with the same name
+     * @return count of parameters accepted by the object
+     */
+    Size applyTo(util::Parameterized &target) const;
+};
+
+/**
+ * @brief Save a wavement to binary file
+ *
+ * @param [in] path file path, overwritten if exists
+ * @param [in] w wavement to save
+ * @param [in] meta optional object whose name and parameters are saved
+ * @return whether the file is written completely
+ */
+bool SOIL_EXPORT saveWavement(const std::string &path, const Wavement &w,
+                              const util::Parameterized *meta = nullptr);
+/** Save a view over external buffers to binary file */
+bool SOIL_EXPORT saveWavement(const std::string &path, const WavementView &w,
+                              const util::Parameterized *meta = nullptr);
+/**
+ * @brief Save a spectrum to binary file
+ *
+ * @param [in] path file path, overwritten if exists
+ * @param [in] spec spectrum to save
+ * @param [in] meta optional object whose name and parameters are saved
+ * @return whether the file is written completely
+ */
+bool SOIL_EXPORT saveSpectrum(const std::string &path, const Spectrum &spec,
+                              const util::Parameterized *meta = nullptr);
+
+class MappedWavementPriv;
+
+/**
+ * @brief Wavement file mapped into memory
+ *
+ * Columns are viewed in place, the view is valid as long as this object.
+ */
+class SOIL_EXPORT MappedWavement {
+public:
+    /**
+     * @brief Map a wavement file
+     *
+     * @param [in] path file path
+     *
+     * @note Throw runtime error if file can't be mapped, or is not a valid
+     *       wavement file of a supported version
+     */
+    explicit MappedWavement(const std::string &path);
+    /** Destructor, unmap file */
+    ~MappedWavement();
+
+    MappedWavement(const MappedWavement &) = delete;
+    MappedWavement &operator=(const MappedWavement &) = delete;
+
+    /** Get view of mapped columns */
+    const WavementView &View() const;
+    /** Get stored metadata */
+    const StoredMetadata &Metadata() const;
+    /** Copy mapped columns into an owning wavement */
+    Wavement toWavement() const;
+
+private:
+    MappedWavementPriv *priv;
+};
+
+class MappedSpectrumPriv;
+
+/**
+ * @brief Spectrum file mapped into memory
+ *
+ * Axes are mapped in place, the maps are valid as long as this object.
+ */
+class SOIL_EXPORT MappedSpectrum {
+public:
+    /**
+     * @brief Map a spectrum file
+     *
+     * @param [in] path file path
+     *
+     * @note Throw runtime error if file can't be mapped, or is not a valid
+     *       spectrum file of a supported version
+     */
+    explicit MappedSpectrum(const std::string &path);
+    /** Destructor, unmap file */
+    ~MappedSpectrum();
+
+    MappedSpectrum(const MappedSpectrum &) = delete;
+    MappedSpectrum &operator=(const MappedSpectrum &) = delete;
+
+    Size Count() const;          /**< point count */
+    Size HermitianCount() const; /**< see #Spectrum::HermitianCount */
+    /** frequency axis */
+    Eigen::Map<const Sequence> Frenquencies() const;
+    /** value axis */
+    Eigen::Map<const Characteristics> Values() const;
+    /** Get stored metadata */
+    const StoredMetadata &Metadata() const;
+    /** Copy mapped axes into an owning spectrum */
+    Spectrum toSpectrum() const;
+
+private:
+    MappedSpectrumPriv *priv;
+};
+
+using MappedWavement_ptr = std::shared_ptr<const MappedWavement>;
+using MappedSpectrum_ptr = std::shared_ptr<const MappedSpectrum>;
+
+/** Map a wavement file, nullptr if it's invalid */
+MappedWavement_ptr SOIL_EXPORT loadWavement(const std::string &path);
+/** Map a spectrum file, nullptr if it's invalid */
+MappedSpectrum_ptr SOIL_EXPORT loadSpectrum(const std::string &path);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_STORAGE_HPP
@@ -0,0 +1,85 @@
+#ifndef SOIL_SIGNAL_TOUCHSTONE_HPP
+#define SOIL_SIGNAL_TOUCHSTONE_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "Eigen/Dense"
+#include "soil_export.h"
+#include "soil/signal/spectrum.hpp"
+#include "soil/signal/tuner.hpp"
+
+/*
+ * Touchstone files of network parameters
+ *
+ * Files of version 1 are supported: comments start with `!`, the option line
+ * `# <unit> <parameter> <format> R <resistance>` gives frequency unit (Hz,
+ * kHz, MHz or GHz, default GHz), parameter type (default S), format of pairs
+ * (RI, MA or DB, default MA) and reference resistance (default 50), and
+ * every frequency is followed by `ports * ports` pairs. Keyword lines of
+ * version 2, starting with `[`, are skipped. Network data of a 2-port file
+ * ends at the first frequency not above the previous one, where the block
+ * of noise parameters begins, and that block is ignored.
+ *
+ * Files are mapped into memory and parsed in one pass by `std::from_chars`,
+ * without any stream or intermediate string.
+ */
+
+namespace soil {
+namespace signal {
+
+/** Network parameters read from a Touchstone file */
+struct SOIL_EXPORT TouchstoneData {
+    Size ports;            /**< count of ports */
+    char parameter;        /**< parameter type, 'S', 'Y', 'Z', 'H' or 'G' */
+    double resistance;     /**< reference resistance, unit: Ohm */
+    Sequence frequencies;  /**< frequency axis, unit: Hz */
+    /** parameters, one row per frequency, see #Parameter for columns */
+    Eigen::MatrixXcd parameters;
+
+    /**
+     * @brief Get parameter from port `from` to port `to`, e.g. S21 is
+     *        `Parameter(2, 1)`
+     *
+     * @param [in] to output port, from 1
+     * @param [in] from input port, from 1
+     * @return parameter on every frequency, empty if ports are invalid
+     */
+    Characteristics Parameter(Size to, Size from) const;
+};
+
+/**
+ * @brief Read a Touchstone file
+ *
+ * @param [in] path file path, count of ports is deduced from extension
+ *             `.sNp`
+ * @param [in] ports count of ports, 0 to deduce it from extension
+ * @return data of file, nullopt if file can't be read, count of ports is
+ *         unknown or file is malformed
+ */
+std::optional<TouchstoneData> SOIL_EXPORT
+readTouchstone(const std::string &path, Size ports = 0);
+
+/**
+ * @brief Load a measured S-parameter from a Touchstone file
+ *
+ * A frequency axis which isn't uniform is resampled onto a uniform one by
+ * linear interpolation of real and imaginary parts.
+ *
+ * @param [in] path file path, see #readTouchstone
+ * @param [in] to output port, from 1
+ * @param [in] from input port, from 1
+ * @param [in] f_step frequency step of uniform axis, 0 to keep point count
+ *             of file
+ * @return measured S-parameter, nullptr if file is invalid, it has less than
+ *         2 frequencies which are not increasing or ports are invalid
+ */
+std::shared_ptr<MeasuredSParameter> SOIL_EXPORT
+loadTouchstone(const std::string &path, Size to = 1, Size from = 1,
+               double f_step = 0.0);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_TOUCHSTONE_HPP
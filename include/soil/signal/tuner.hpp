@@ -2,6 +2,7 @@
 #define SOIL_SIGNAL_TUNER_HPP
 
 #include <memory>
+#include <vector>
 
 #include "soil_export.h"
 #include "soil/signal/spectrum.hpp"
@@ -30,6 +31,17 @@ public:
      * @return tuned spectrum
      */
     virtual Spectrum tune(const Spectrum &spec) const = 0;
+    /**
+     * @brief Get frequency response on the frequency axis of a spectrum
+     *
+     * It's the factor applied to every bin by a linear tuner. The default
+     * implementation tunes a spectrum of ones on the same axis.
+     *
+     * @param [in] spec spectrum whose frequency axis is used, values are
+     *             ignored
+     * @return response, one value per bin
+     */
+    virtual Characteristics response(const Spectrum &spec) const;
 
 protected:
     explicit Tuner(const std::string &name);
@@ -42,8 +54,23 @@ using SParameter = Tuner;
 
 class MeasuredSPriv;
 
-/** S-Parameter with measured frequency characteristics */
-class SOIL_EXPORT MeasuredSParameter : SParameter {
+/**
+ * @brief S-Parameter with measured frequency characteristics
+ *
+ * Measured characteristics are interpolated on frequencies of tuned
+ * spectrum, bins outside measured range are not changed.
+ *
+ * Two parameters:
+ * - interpolation, "nearest" (default), "linear" or "cubic", type:
+ *   std::string
+ * - polar, whether magnitude and unwrapped phase are interpolated instead of
+ *   real and imaginary parts, type: bool
+ *
+ * Interpolated response is cached for the most recently used uniform
+ * frequency grids, so that tuning spectra on the same grid again is one
+ * product per bin.
+ */
+class SOIL_EXPORT MeasuredSParameter : public SParameter {
 public:
     /**
      * @brief Construct a new Measured S Parameter object
@@ -51,17 +78,83 @@ public:
      * @param [in] f0 beginning frequency of measured data
      * @param [in] f_step frequency step, >1e-9
      * @param [in] ch measured characteristics
+     * @param [in] interpolation default interpolation mode
+     * @param [in] polar default choice of polar interpolation
+     *
+     * @note Throw runtime error if step or interpolation mode is invalid
      */
     explicit MeasuredSParameter(double f0, double f_step,
-                                const Characteristics &ch);
+                                const Characteristics &ch,
+                                const std::string &interpolation = "nearest",
+                                bool polar = false);
     ~MeasuredSParameter();
     Spectrum tune(const Spectrum &spec) const;
+    Characteristics response(const Spectrum &spec) const;
+
+protected:
+    bool checkParameter(const std::string &name, const std::any &current,
+                        const std::any &next) const;
 
 private:
     MeasuredSPriv *priv;
+    util::ParamId<std::string> interpolation_id;
+    util::ParamId<bool> polar_id;
+};
+
+class TunerCascadePriv;
+
+/**
+ * @brief Cascade of tuners applied one after another
+ *
+ * Responses of all stages are folded into one combined response, which is
+ * cached for the most recently used uniform frequency grids, so that tuning
+ * costs one product per bin whatever the count of stages. A cached response
+ * is folded again once parameters of any stage change. Stages must be
+ * linear, i.e. tuning multiplies every bin by its response.
+ *
+ * @note Changes inside a stage which is itself a cascade are not tracked,
+ *       append its stages instead
+ *
+ * No valid parameter.
+ */
+class SOIL_EXPORT TunerCascade : public Tuner {
+public:
+    /**
+     * @brief Construct a new Tuner Cascade object
+     *
+     * @param [in] tuners stages in order of application, null ones are
+     *             ignored
+     */
+    explicit TunerCascade(const std::vector<Tuner_ptr> &tuners = {});
+    /** Destructor */
+    ~TunerCascade();
+
+    /** Append a stage at the end, ignored if null */
+    void append(const Tuner_ptr &tuner);
+    /** Get stages in order of application */
+    std::vector<Tuner_ptr> Tuners() const;
+
+    Spectrum tune(const Spectrum &spec) const;
+    Characteristics response(const Spectrum &spec) const;
+
+private:
+    TunerCascadePriv *priv;
 };
 
-/** Signal channel considered as a frequency tuner */
+/**
+ * @brief Signal channel considered as a frequency tuner
+ *
+ * Wavement is transformed by #wavementToSpectrum, tuned, and transformed
+ * back on its original time axis. A half spectrum returned by the tuner
+ * without Hermitian count, e.g. rebuilt from frequencies and values, keeps
+ * the count of input spectrum.
+ *
+ * Wavement is returned unchanged if there is no tuner or it can't be
+ * transformed, see #wavementToSpectrum.
+ *
+ * @note Processing throws runtime error if tuned spectrum doesn't transform
+ *       back to the point count of wavement
+ */
 class SOIL_EXPORT TunerChannel : public Channel {
 public:
     /**
@@ -75,11 +168,86 @@ public:
     void setTuner(const Tuner_ptr &tuner);
 
     Wavement via(const Wavement &w) const;
+    Wavement viaView(const WavementView &w) const;
 
 private:
     Tuner_ptr tuner;
 };
 
+class StreamingTunerPriv;
+
+/**
+ * @brief Signal channel applying a tuner to an unbounded stream of blocks
+ *
+ * The tuner is sampled on `taps` frequency points and turned into a causal
+ * FIR filter, which is applied to incoming blocks by overlap-save
+ * convolution. Memory is constant: only the last `taps - 1` samples of every
+ * column are kept between blocks, and output of each block is available
+ * immediately with a fixed latency of `taps / 2` samples.
+ *
+ * Version of tuner parameters is checked for every block, and the tuner is
+ * sampled again once it changes, so a parameter set mid-stream applies from
+ * the next block on while filter state is kept.
+ *
+ * Without "imag" column, every column is filtered as an independent real
+ * stream. With "imag" column, "real" (or "amp") and "imag" columns form a
+ * complex stream whose output has "real" and "imag" columns, a missing real
+ * column is taken as zeros. Any other column is still filtered as a real
+ * stream and kept in output after them.
+ *
+ * @note Referee of input must be uniform with the interval given in
+ *       constructor, which is not verified for every block.
+ */
+class SOIL_EXPORT StreamingTunerChannel : public Channel {
+public:
+    /**
+     * @brief Construct a new Streaming Tuner Channel object
+     *
+     * @param [in] tuner tuner shared pointer
+     * @param [in] interval sample interval of streams, >0
+     * @param [in] block_size maximum points processed by one transformation
+     * @param [in] taps length of FIR filter, frequency resolution of tuner
+     *             sampling is `1 / (taps * interval)`
+     *
+     * @note Throw runtime error if interval, block size or taps is invalid
+     */
+    explicit StreamingTunerChannel(const Tuner_ptr &tuner, double interval,
+                                   Size block_size = 4096, Size taps = 1024);
+    /** Destructor */
+    ~StreamingTunerChannel();
+
+    /** Change tuner, filter state is reset as well */
+    void setTuner(const Tuner_ptr &tuner);
+
+    Size BlockSize() const; /**< maximum points of one transformation */
+    Size Taps() const;      /**< length of FIR filter */
+    Size Latency() const;   /**< delay of output, in samples */
+
+    /**
+     * @brief Process next block of stream
+     *
+     * Blocks of any length are accepted, longer ones are split internally.
+     * Output keeps referee of the block, while its values are delayed by
+     * `Latency()` samples.
+     *
+     * @param [in] block next block of stream
+     * @return filtered block with the same point count
+     */
+    Wavement feed(const Wavement &block);
+    /** Clear filter state, as if no block has been fed */
+    void reset();
+
+    /**
+     * @brief Stream a whole wavement through a fresh filter state
+     *
+     * Latency is compensated, so output is aligned to input.
+     */
+    Wavement via(const Wavement &w) const;
+
+private:
+    StreamingTunerPriv *priv;
+};
+
 } // namespace signal
 } // namespace soil
 
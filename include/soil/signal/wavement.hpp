@@ -19,6 +19,23 @@ using Sequence = Eigen::VectorXd;
 using Size = Eigen::Index;
 using Index = Eigen::Index;
 
+/** read-only reference to a contiguous sequence, e.g. a column of values */
+using ConstSequenceRef = Eigen::Ref<const Sequence>;
+/** writable reference to a contiguous sequence */
+using SequenceRef = Eigen::Ref<Sequence>;
+
+/**
+ * @brief Uniform referee, the i-th point is `start + i * step`
+ *
+ * Points are the ones of `Sequence::LinSpaced(count, start, start + (count -
+ * 1) * step)`, so that the last point is exact.
+ */
+struct UniformGrid {
+    double start;
+    double step;
+    Size count;
+};
+
 class WavementPriv;
 
 /**
@@ -27,6 +44,23 @@ class WavementPriv;
  * The referee is a vector, normally representing time sequence.
  * The values can contain any number of columns, each has a key and a vector.
  * The size of referee must be the same with the size of every column in values.
+ *
+ * All columns are stored contiguously in one column-major matrix, in the
+ * order they are added, and addressed through a small key-to-index table.
+ * Multi-column kernels can stream through `ValueMatrix()` directly, and
+ * columns can be accessed by index to skip key lookup.
+ *
+ * `Values` returns a copy of a column, which stays valid whatever happens to
+ * the wavement. Like iterators of `std::vector`, references returned by
+ * `ValuesRef`, `ValueMatrix` and their mutable versions are invalidated when
+ * a column is added beyond the reserved count, when referee is set and when
+ * wavement is assigned. Capacity grows geometrically, and `reserveValues`
+ * keeps references valid while columns are added up to the reserved count.
+ *
+ * A uniform referee is held implicitly as a #UniformGrid, it's detected when
+ * the referee is set if it's exactly `Sequence::LinSpaced` of its first and
+ * last points. Such referee is only materialized when it's first read
+ * through `Referee()`, and the mapping between index and referee is O(1).
  */
 class SOIL_EXPORT Wavement {
 public:
@@ -35,6 +69,8 @@ public:
     /** Constructor with given referee */
     explicit Wavement(const Sequence &referee);
     explicit Wavement(Sequence &&referee);
+    /** Constructor with implicit uniform referee */
+    explicit Wavement(const UniformGrid &grid);
 
     /** Copy constructor */
     Wavement(const Wavement &other);
@@ -56,6 +92,16 @@ public:
      */
     void setReferee(const Sequence &referee);
     void setReferee(Sequence &&referee);
+    void setReferee(const UniformGrid &grid);
+    /**
+     * @brief Shift every point of referee, values are kept
+     *
+     * A uniform referee is shifted in O(1), its points may differ from the
+     * ones shifted one by one by rounding.
+     *
+     * @param [in] delay shift added to referee
+     */
+    void shiftReferee(double delay);
     /**
      * @brief Add a specific value column
      *
@@ -64,23 +110,112 @@ public:
      */
     void setValues(const std::string &key, const Sequence &values);
     void setValues(const std::string &key, Sequence &&values);
+    /**
+     * @brief Add several value columns at once
+     *
+     * If wavement has no column yet, the matrix is taken without copy.
+     * Nothing is added if any key is invalid or sizes don't match.
+     *
+     * @param [in] keys keys of columns, in the order of matrix columns
+     * @param [in] values value matrix, one column per key
+     */
+    void setValues(const std::vector<std::string> &keys,
+                   Eigen::MatrixXd &&values);
+    /**
+     * @brief Reserve storage for given count of columns
+     *
+     * Adding columns never reallocates until reserved count is exceeded, so
+     * references to values stay valid meanwhile.
+     *
+     * @param [in] count expected count of columns
+     */
+    void reserveValues(Size count);
 
     /** Get count of point, a.k.a. size of referee or any column of values */
     Size PointCount() const;
     /** Get count of columns in values */
     Size ValueCount() const;
 
-    /** Get referee vector */
+    /**
+     * @brief Get referee vector
+     *
+     * A uniform referee is materialized at first call, it's thread-safe.
+     */
     const Sequence &Referee() const;
-    /** Get keys of all columns in values */
+    /** Get uniform grid of referee, nullopt if referee isn't uniform */
+    std::optional<UniformGrid> Grid() const;
+    /**
+     * @brief Get referee at given index, O(1) for uniform referee
+     *
+     * @param [in] index point index
+     * @return referee point, NaN if index is invalid
+     */
+    double RefereeAt(Index index) const;
+    /**
+     * @brief Get index of the point nearest to given referee
+     *
+     * It's O(1) for uniform referee, otherwise the referee must be
+     * increasing and it's searched by bisection.
+     *
+     * @param [in] referee referee to locate
+     * @return index of the nearest point, -1 if wavement is empty
+     */
+    Index NearestIndex(double referee) const;
+    /** Get keys of all columns in values, in the order they are added */
     std::vector<std::string> Keys() const;
     /**
-     * Get vector of column with given key
+     * Get index of column with given key
+     *
+     * @param [in] key column key
+     * @return column index, -1 if `key` non-exists
+     */
+    Index KeyIndex(const std::string &key) const;
+    /**
+     * Get copy of column with given key
+     *
+     * @param [in] key column key
+     * @return column vector, empty vector if `key` non-exists
+     */
+    Sequence Values(const std::string &key) const;
+    /**
+     * Get copy of column with given index
+     *
+     * @param [in] column column index, see #KeyIndex
+     * @return column vector, empty vector if index is invalid
+     */
+    Sequence Values(Index column) const;
+    /**
+     * Get column with given key without copy
+     *
+     * @note The reference is invalidated by adding columns beyond reserved
+     *       count, see #reserveValues, use `Values` to keep a column
      *
      * @param [in] key column key
      * @return column vector, empty vector if `key` non-exists
      */
-    const Sequence &Values(const std::string &key) const;
+    ConstSequenceRef ValuesRef(const std::string &key) const;
+    /** Get column with given index without copy, see #ValuesRef */
+    ConstSequenceRef ValuesRef(Index column) const;
+    /**
+     * Get all columns as a column-major matrix
+     *
+     * Column `i` of the matrix is the column with index `i`, see #KeyIndex.
+     */
+    Eigen::Ref<const Eigen::MatrixXd> ValueMatrix() const;
+
+    /**
+     * @brief Get writable referee, for processing in place
+     *
+     * Size can't be changed through the reference, use `setReferee` instead.
+     * A uniform referee is materialized and becomes explicit.
+     */
+    SequenceRef MutableReferee();
+    /** Get writable column with given key, empty if `key` non-exists */
+    SequenceRef MutableValues(const std::string &key);
+    /** Get writable column with given index, empty if index is invalid */
+    SequenceRef MutableValues(Index column);
+    /** Get all columns as a writable column-major matrix */
+    Eigen::Ref<Eigen::MatrixXd> MutableValueMatrix();
 
     /** Information of a single point in wavement */
     struct Point {
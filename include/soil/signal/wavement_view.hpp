@@ -0,0 +1,98 @@
+#ifndef SOIL_SIGNAL_WAVEMENT_VIEW_HPP
+#define SOIL_SIGNAL_WAVEMENT_VIEW_HPP
+
+#include <string>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "soil_export.h"
+#include "soil/signal/wavement.hpp"
+
+namespace soil {
+namespace signal {
+
+/** read-only map of a sequence in external buffer, with any inner stride */
+using SequenceMap = Eigen::Map<const Sequence, 0, Eigen::InnerStride<>>;
+
+class WavementViewPriv;
+
+/**
+ * @brief Non-owning view of wavement over externally owned buffers
+ *
+ * A view only records pointers and strides of referee and columns, so that
+ * samples in DMA buffers or mapped files can be processed without copy. The
+ * buffers must outlive the view and all of its copies. Any owning #Wavement
+ * is only built by `toWavement`, or by a processor which has to write.
+ *
+ * Strides are counted in doubles, e.g. columns of an interleaved buffer of
+ * `k` channels all have stride `k`.
+ */
+class SOIL_EXPORT WavementView {
+public:
+    /**
+     * @brief Construct a view over external referee
+     *
+     * @param [in] referee pointer to first referee value
+     * @param [in] count point count
+     * @param [in] stride distance between consecutive referee values
+     */
+    WavementView(const double *referee, Size count, Index stride = 1);
+    /**
+     * @brief Construct a view over an owning wavement
+     *
+     * @param [in] w viewed wavement, must outlive the view and stay unchanged
+     */
+    explicit WavementView(const Wavement &w);
+
+    /** Copy constructor */
+    WavementView(const WavementView &other);
+    /** Move constructor */
+    WavementView(WavementView &&other);
+
+    /** Destructor */
+    ~WavementView();
+
+    /** Copy assignment */
+    WavementView &operator=(const WavementView &other);
+    /** Move assignment */
+    WavementView &operator=(WavementView &&other);
+
+    /**
+     * @brief Add a column over external buffer
+     *
+     * @param [in] key non-empty column key, not added yet
+     * @param [in] values pointer to first value of column, `PointCount()`
+     *             values are viewed
+     * @param [in] stride distance between consecutive values
+     * @return whether column is added
+     */
+    bool addValues(const std::string &key, const double *values,
+                   Index stride = 1);
+
+    /** Get count of point */
+    Size PointCount() const;
+    /** Get count of columns */
+    Size ValueCount() const;
+
+    /** Get referee */
+    SequenceMap Referee() const;
+    /** Get keys of all columns, in the order they are added */
+    std::vector<std::string> Keys() const;
+    /** Get index of column with given key, -1 if non-exists */
+    Index KeyIndex(const std::string &key) const;
+    /** Get column with given key, empty if `key` non-exists */
+    SequenceMap Values(const std::string &key) const;
+    /** Get column with given index, empty if index is invalid */
+    SequenceMap Values(Index column) const;
+
+    /** Copy viewed data into an owning wavement */
+    Wavement toWavement() const;
+
+private:
+    WavementViewPriv *priv;
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_WAVEMENT_VIEW_HPP
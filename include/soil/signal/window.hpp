@@ -1,12 +1,16 @@
 #ifndef SOIL_SIGNAL_WINDOW_HPP
 #define SOIL_SIGNAL_WINDOW_HPP
 
+#include <vector>
+
 #include "soil_export.h"
 #include "soil/signal/processor.hpp"
 
 namespace soil {
 namespace signal {
 
+class WindowPriv;
+
 /**
  * @brief Abstract interface of signal window
  *
@@ -14,8 +18,38 @@ namespace signal {
  * - begin --- begin timestamp of window, unit: s
  * - duration --- duration of window, unit: s, >0.0
  * - max_amp --- maximum amplitude
+ *
+ * Processing multiplies every column by `max_amp * shape((t - begin) /
+ * duration)`, where `t` is referee and shape is 0 out of `[0, 1]`.
+ * Subclasses only implement the shape.
+ *
+ * Gains on a uniform referee and coefficient tables are cached, keyed by
+ * grid or length and by version of parameters, so that windowing again with
+ * the same settings is one multiplication per value, and changing any
+ * parameter never reuses stale gains.
  */
 class SOIL_EXPORT Window : public Processor {
+public:
+    /** Destructor */
+    ~Window();
+
+    Wavement via(const Wavement &w) const;
+    void process(Wavement &w) const;
+
+    /**
+     * @brief Get coefficients of window shape on a frame, e.g. before FFT
+     *
+     * Only the shape is sampled, `begin`, `duration` and `max_amp` are not
+     * concerned.
+     *
+     * @param [in] length count of coefficients, >0
+     * @param [in] periodic whether shape is sampled at `i / length` for
+     *             spectral analysis, or at `i / (length - 1)` so that table
+     *             is symmetric
+     * @return coefficients, empty if length isn't positive
+     */
+    Sequence Coefficients(Size length, bool periodic = true) const;
+
 protected:
     /**
      * @brief Construct a new Window object
@@ -31,6 +65,100 @@ protected:
     virtual bool checkParameter(const std::string &name,
                                 const std::any &current,
                                 const std::any &next) const;
+
+    /**
+     * @brief Evaluate window shape, must be implemented
+     *
+     * @param [in] x normalized positions, in `[0, 1]`
+     * @param [in] params snapshot of parameters
+     * @param [out] values shape at every position, 1 at its peak
+     */
+    virtual void shape(ConstSequenceRef x,
+                       const util::ParameterSnapshot &params,
+                       SequenceRef values) const = 0;
+
+    util::ParamId<double> begin_id;    /**< handle of 'begin' parameter */
+    util::ParamId<double> duration_id; /**< handle of 'duration' parameter */
+    util::ParamId<double> max_amp_id;  /**< handle of 'max_amp' parameter */
+
+private:
+    WindowPriv *priv;
+};
+
+/**
+ * @brief Abstract window whose shape is a sum of cosines,
+ *        `sum((-1)^k * a[k] * cos(2 * pi * k * x))`
+ */
+class SOIL_EXPORT CosineSumWindow : public Window {
+protected:
+    /**
+     * @brief Construct a new Cosine Sum Window object
+     *
+     * @param [in] name name passed to #soil::util::Parameterized
+     * @param [in] coeffs coefficients `a[k]` of cosines
+     * @param [in] begin default begin timestamp
+     * @param [in] duration default duration
+     * @param [in] max_amp default maximum amplitude
+     */
+    CosineSumWindow(const std::string &name,
+                    const std::vector<double> &coeffs, double begin,
+                    double duration, double max_amp);
+
+    void shape(ConstSequenceRef x, const util::ParameterSnapshot &params,
+               SequenceRef values) const;
+
+private:
+    std::vector<double> coeffs;
+};
+
+/** Hann window, `0.5 - 0.5 * cos(2 * pi * x)` */
+class SOIL_EXPORT HannWindow : public CosineSumWindow {
+public:
+    explicit HannWindow(double begin = 0.0, double duration = 1.0,
+                        double max_amp = 1.0);
+};
+
+/** Hamming window, `0.54 - 0.46 * cos(2 * pi * x)` */
+class SOIL_EXPORT HammingWindow : public CosineSumWindow {
+public:
+    explicit HammingWindow(double begin = 0.0, double duration = 1.0,
+                           double max_amp = 1.0);
+};
+
+/** 4-term Blackman-Harris window, side lobes below -92dB */
+class SOIL_EXPORT BlackmanHarrisWindow : public CosineSumWindow {
+public:
+    explicit BlackmanHarrisWindow(double begin = 0.0, double duration = 1.0,
+                                  double max_amp = 1.0);
+};
+
+/** 5-term flat-top window, for accurate amplitude of tones */
+class SOIL_EXPORT FlatTopWindow : public CosineSumWindow {
+public:
+    explicit FlatTopWindow(double begin = 0.0, double duration = 1.0,
+                           double max_amp = 1.0);
+};
+
+/**
+ * @brief Kaiser window, `I0(beta * sqrt(1 - (2x - 1)^2)) / I0(beta)`
+ *
+ * One additional parameter:
+ * - beta --- shape factor, >=0.0, larger for lower side lobes and wider
+ *   main lobe
+ */
+class SOIL_EXPORT KaiserWindow : public Window {
+public:
+    explicit KaiserWindow(double beta = 8.6, double begin = 0.0,
+                          double duration = 1.0, double max_amp = 1.0);
+
+protected:
+    bool checkParameter(const std::string &name, const std::any &current,
+                        const std::any &next) const;
+    void shape(ConstSequenceRef x, const util::ParameterSnapshot &params,
+               SequenceRef values) const;
+
+private:
+    util::ParamId<double> beta_id;
 };
 
 } // namespace signal
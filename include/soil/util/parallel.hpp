@@ -0,0 +1,116 @@
+#ifndef SOIL_UTIL_PARALLEL_HPP
+#define SOIL_UTIL_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+
+#include "soil_export.h"
+
+namespace soil {
+namespace util {
+
+/**
+ * @brief Set count of threads used by the library
+ *
+ * The library owns one work-stealing pool of worker threads shared by all
+ * parallel loops and task groups. Every worker keeps its own queue of tasks,
+ * runs the newest task of it first and steals the oldest tasks of others
+ * when it's empty. With 1 thread, the default, everything runs serially on
+ * the calling thread.
+ * Results never depend on the thread count, see #parallelFor.
+ *
+ * @param [in] count count of threads including the calling one, 0 for
+ *             hardware concurrency
+ *
+ * @note It must not be called while a parallel loop is running
+ */
+void SOIL_EXPORT setThreadCount(std::size_t count);
+/** Get count of threads used by the library */
+std::size_t SOIL_EXPORT ThreadCount();
+
+/**
+ * @brief Run a loop body on chunks of a range, in parallel if possible
+ *
+ * The range `[0, count)` is split into chunks of `grain` elements, the last
+ * one may be shorter. Boundaries of chunks only depend on `count` and
+ * `grain`, so that a body whose result only depends on its chunk produces
+ * bit-identical results with any thread count. The calling thread processes
+ * chunks as well, so loops can be nested.
+ *
+ * @param [in] count count of elements
+ * @param [in] grain count of elements in one chunk, >0
+ * @param [in] body function processing chunk `[begin, end)`, called
+ *             concurrently from different threads
+ *
+ * @note The first exception thrown by body is rethrown after all chunks are
+ *       finished
+ */
+void SOIL_EXPORT
+parallelFor(std::size_t count, std::size_t grain,
+            const std::function<void(std::size_t, std::size_t)> &body);
+
+/**
+ * @brief Run a loop body on blocks of a matrix, in parallel if possible
+ *
+ * Columns with at least `grain` rows are split into chunks of `grain` rows,
+ * one column per block. Shorter columns are kept whole and grouped by
+ * `grain / rows` columns, so that wide and short matrices are split as well.
+ * Boundaries of blocks only depend on `rows`, `cols` and `grain`, see
+ * #parallelFor.
+ *
+ * @param [in] rows count of rows
+ * @param [in] cols count of columns
+ * @param [in] grain count of elements in one block, >0
+ * @param [in] body function processing rows `[row_begin, row_end)` of
+ *             columns `[col_begin, col_end)`, called concurrently
+ */
+void SOIL_EXPORT parallelForBlocks(
+    std::size_t rows, std::size_t cols, std::size_t grain,
+    const std::function<void(std::size_t row_begin, std::size_t row_end,
+                             std::size_t col_begin, std::size_t col_end)>
+        &body);
+
+class TaskGroupPriv;
+
+/**
+ * @brief Group of tasks running on the library pool
+ *
+ * Tasks spawned from a worker are pushed to its own queue, so that a task
+ * spawning further tasks keeps them local unless other workers are idle.
+ * Waiting threads execute pending tasks instead of blocking, so groups can
+ * be nested. With 1 thread, tasks run immediately when spawned.
+ */
+class SOIL_EXPORT TaskGroup {
+public:
+    /** Construct an empty group */
+    TaskGroup();
+    /** Destructor, wait for all tasks */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /**
+     * @brief Spawn a task, it may be spawned by another task of the group
+     *
+     * @param [in] task task to run
+     */
+    void run(std::function<void()> task);
+    /**
+     * @brief Wait for all spawned tasks, executing pending tasks meanwhile
+     *
+     * When no task is left to execute, the thread yields for a few rounds
+     * and then sleeps until the last task of the group finishes.
+     *
+     * @note The first exception thrown by tasks is rethrown
+     */
+    void wait();
+
+private:
+    TaskGroupPriv *priv;
+};
+
+} // namespace util
+} // namespace soil
+
+#endif // SOIL_UTIL_PARALLEL_HPP
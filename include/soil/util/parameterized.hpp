@@ -1,6 +1,8 @@
 #ifndef SOIL_UTIL_PARAMETERIZED_HPP
 #define SOIL_UTIL_PARAMETERIZED_HPP
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <any>
@@ -11,6 +13,90 @@ namespace soil {
 namespace util {
 
 class ParameterizedPriv;
+class Parameterized;
+class ParameterSnapshot;
+struct ParameterValues;
+
+/**
+ * @brief Typed handle of a prepared parameter
+ *
+ * Handles are returned by `Parameterized::prepareParameter`, reading a
+ * parameter by handle is a direct access to its slot without name lookup or
+ * copy of `std::any`. A default constructed handle is invalid.
+ *
+ * @tparam T value type of parameter
+ */
+template <typename T> class ParamId {
+public:
+    /** Construct an invalid handle */
+    ParamId() : slot(-1) {}
+
+    /** Whether handle refers to a prepared parameter */
+    bool Valid() const { return slot >= 0; }
+
+private:
+    explicit ParamId(int slot) : slot(slot) {}
+
+    int slot;
+
+    friend class Parameterized;
+    friend class ParameterSnapshot;
+};
+
+/**
+ * @brief Immutable snapshot of all parameters of an object
+ *
+ * A snapshot is taken by `Parameterized::Snapshot`, it's a guard pinning the
+ * parameter values published at that moment. Setters never modify pinned
+ * values, they publish new values and never wait for readers, old values
+ * are freed when the last snapshot referring to them is destroyed. So worker
+ * threads can read parameters while a control thread is setting them, and a
+ * thread holding a snapshot can set parameters of the same object.
+ *
+ * @note A snapshot must not outlive its object
+ */
+class SOIL_EXPORT ParameterSnapshot {
+public:
+    /** Move constructor */
+    ParameterSnapshot(ParameterSnapshot &&other);
+    /** Destructor, release pinned values */
+    ~ParameterSnapshot();
+
+    ParameterSnapshot(const ParameterSnapshot &) = delete;
+    ParameterSnapshot &operator=(const ParameterSnapshot &) = delete;
+
+    /** Get version of values, increased by every successful setting */
+    std::uint64_t Version() const;
+    /** see Parameterized::Parameter */
+    std::any Parameter(const std::string &name,
+                       const std::any &def = 0.0) const;
+    /**
+     * @brief Get the parameter value by typed handle
+     *
+     * @return reference to value, valid as long as the snapshot
+     *
+     * @note Throw std::bad_any_cast if handle is invalid or value type has
+     *       been changed by a permissive `checkParameter`
+     */
+    template <typename T> const T &ParameterAs(const ParamId<T> &id) const {
+        auto value = std::any_cast<T>(Slot(id.slot));
+        if (value == nullptr) {
+            throw std::bad_any_cast();
+        }
+        return *value;
+    }
+
+private:
+    explicit ParameterSnapshot(ParameterizedPriv *owner);
+
+    /** value in given slot, nullptr if slot is invalid */
+    const std::any *Slot(int slot) const;
+
+    ParameterizedPriv *owner;
+    std::shared_ptr<const ParameterValues> values;
+
+    friend class Parameterized;
+};
 
 /**
  * @brief Abstract interface with parameters
@@ -30,6 +116,13 @@ class ParameterizedPriv;
  *    using `prepareParameter` to define parameters;
  * 2. `checkParameter` method to guard parameter setting, the default
  *    implementation only concerns the value types.
+ *
+ * Parameters can be read and set from different threads. Every read sees a
+ * consistent #ParameterSnapshot, and an implementation reading several
+ * parameters, or reading in a loop, must take one snapshot by `Snapshot` per
+ * call and read all values from it. Settings are serialized with each other
+ * but never block the readers. Parameters should only be prepared in
+ * constructors.
  */
 class SOIL_EXPORT Parameterized {
 public:
@@ -44,6 +137,10 @@ public:
     /**
      * @brief Get the parameter value according to given name
      *
+     * Every getter of this class takes a snapshot for one value, hot paths
+     * and implementations reading several values should hold a `Snapshot`
+     * instead.
+     *
      * @param [in] name parameter name
      * @param [in] def default value
      * @return parameter value, use default if parameter name invalid
@@ -62,6 +159,24 @@ public:
     T ParameterAs(const std::string &name, const T &def) const {
         return std::any_cast<T>(Parameter(name, std::make_any<T>(def)));
     }
+    /**
+     * @brief Get the parameter value by typed handle
+     *
+     * @tparam T value type
+     * @param [in] id handle returned by `prepareParameter`
+     * @return parameter value
+     *
+     * @note Throw std::bad_any_cast if handle is invalid or value type has
+     *       been changed by a permissive `checkParameter`
+     * @note It takes a snapshot per call, which costs two atomic operations
+     *       and a copy, don't call it per block or per point, read a held
+     *       `Snapshot` instead
+     */
+    template <typename T> T ParameterAs(const ParamId<T> &id) const {
+        return Snapshot().ParameterAs(id);
+    }
+    /** Take a snapshot of current parameter values, see #ParameterSnapshot */
+    ParameterSnapshot Snapshot() const;
     /**
      * @brief Set the parameter value
      *
@@ -69,6 +184,15 @@ public:
      * @param [in] value parameter value
      */
     bool setParameter(const std::string &name, const std::any &value);
+    /**
+     * @brief Set the parameter value by typed handle
+     *
+     * @param [in] id handle returned by `prepareParameter`
+     * @param [in] value parameter value, guarded by `checkParameter` as well
+     */
+    template <typename T> bool setParameter(const ParamId<T> &id, T value) {
+        return setParameterSlot(id.slot, std::make_any<T>(std::move(value)));
+    }
 
 protected:
     /** Constructor with name assigning */
@@ -81,6 +205,29 @@ protected:
      * @param [in] init_value initial value
      */
     void prepareParameter(const std::string &name, const std::any &init_value);
+    /**
+     * @brief prepare a typed parameter
+     *
+     * @tparam T value type
+     * @param [in] name parameter name
+     * @param [in] init_value initial value
+     * @return handle for fast access, invalid if name is already prepared
+     */
+    template <typename T>
+    ParamId<T> prepareParameter(const std::string &name, const T &init_value) {
+        return ParamId<T>(
+            prepareParameterSlot(name, std::make_any<T>(init_value)));
+    }
+    /**
+     * @brief prepare a string parameter from a literal
+     *
+     * The value is stored as `std::string`, a literal would otherwise deduce
+     * an array type which can't be stored.
+     */
+    ParamId<std::string> prepareParameter(const std::string &name,
+                                          const char *init_value) {
+        return prepareParameter(name, std::string(init_value));
+    }
     /**
      * @brief Guard the parameter setting
      *
@@ -95,6 +242,11 @@ protected:
 
 private:
     ParameterizedPriv *priv;
+
+    bool setParameterSlot(int slot, const std::any &value);
+    /** prepare a parameter, return its slot or -1 if name exists */
+    int prepareParameterSlot(const std::string &name,
+                             const std::any &init_value);
 };
 
 } // namespace util
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "axis.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** whether sequence is exactly `Sequence::LinSpaced` of its end points */
+bool linSpaced(const Sequence &seq) {
+    Size n = seq.size();
+    return (n > 1) &&
+           (seq.array() == Sequence::LinSpaced(n, seq[0], seq[n - 1]).array())
+               .all();
+}
+
+/** interval of an implicit grid, nullopt if it isn't increasing */
+std::optional<double> gridStep(const UniformGrid &grid) {
+    return ((grid.count > 1) && (grid.step > 0.0))
+               ? std::optional<double>(grid.step)
+               : std::nullopt;
+}
+
+} // namespace
+
+std::optional<double>
+uniformStep(const Eigen::Ref<const Sequence, 0, Eigen::InnerStride<>> &axis,
+            double tolerance) {
+    Size n = axis.size();
+    if (n < 2) {
+        return std::nullopt;
+    }
+    double step = (axis[n - 1] - axis[0]) / double(n - 1);
+    if (!(step > 0.0)) {
+        return std::nullopt;
+    }
+    for (Index i = 1; i < n; ++i) {
+        if (std::fabs(axis[i] - axis[0] - step * double(i)) >
+            tolerance * step) {
+            return std::nullopt;
+        }
+    }
+    return step;
+}
+
+std::optional<double> uniformStep(const Wavement &w) {
+    auto grid = w.Grid();
+    return grid.has_value() ? gridStep(grid.value())
+                            : uniformStep(w.Referee());
+}
+
+std::optional<double> uniformStep(const Spectrum &spec) {
+    auto grid = spec.Grid();
+    return grid.has_value() ? gridStep(grid.value())
+                            : uniformStep(spec.Frenquencies());
+}
+
+Axis::Axis(const Axis &other) { *this = other; }
+
+Axis &Axis::operator=(const Axis &other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (other.uniform) {
+        // copy grid only, points are materialized again if needed
+        assignGrid(other.first, other.last, other.count);
+    } else {
+        points = other.points;
+        count = other.count;
+        uniform = false;
+        materialized.store(true);
+    }
+    return *this;
+}
+
+void Axis::assign(const Sequence &seq) {
+    if (linSpaced(seq)) {
+        assignGrid(seq[0], seq[seq.size() - 1], seq.size());
+    } else {
+        assign(Sequence(seq));
+    }
+}
+
+void Axis::assign(Sequence &&seq) {
+    if (linSpaced(seq)) {
+        assignGrid(seq[0], seq[seq.size() - 1], seq.size());
+    } else {
+        count = seq.size();
+        points = std::move(seq);
+        uniform = false;
+        materialized.store(true);
+    }
+}
+
+void Axis::assign(const UniformGrid &grid) {
+    Size n = std::max(Size(0), grid.count);
+    assignGrid(grid.start, grid.start + double(n - 1) * grid.step, n);
+}
+
+void Axis::assignGrid(double from, double to, Size n) {
+    count = n;
+    uniform = true;
+    first = from;
+    last = (n > 1) ? to : from;
+    step = (n > 1) ? (last - first) / double(n - 1) : 0.0;
+    points.resize(0);
+    materialized.store(false);
+}
+
+void Axis::shift(double delta) {
+    if (uniform) {
+        assignGrid(first + delta, last + delta, count);
+    } else {
+        points.array() += delta;
+    }
+}
+
+const Sequence &Axis::Points() const {
+    if (!materialized.load()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!materialized.load()) {
+            points = Sequence::LinSpaced(count, first, last);
+            materialized.store(true);
+        }
+    }
+    return points;
+}
+
+Sequence &Axis::MutablePoints() {
+    Points();
+    uniform = false;
+    return points;
+}
+
+std::optional<UniformGrid> Axis::Grid() const {
+    if (uniform) {
+        return UniformGrid{first, step, count};
+    }
+    return std::nullopt;
+}
+
+double Axis::At(Index index) const {
+    if ((index < 0) || (index >= count)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    } else if (!uniform) {
+        return points[index];
+    }
+    // same as the points of `Sequence::LinSpaced`
+    if (index == 0) {
+        return first;
+    } else if (index == count - 1) {
+        return last;
+    } else if (std::fabs(last) < std::fabs(first)) {
+        return last - double(count - 1 - index) * step;
+    }
+    return first + double(index) * step;
+}
+
+Index Axis::Nearest(double point) const {
+    if (count == 0) {
+        return -1;
+    }
+    if (uniform) {
+        if (step == 0.0) {
+            return 0;
+        }
+        double pos = std::round((point - first) / step);
+        return (pos > 0.0) ? Index(std::min(pos, double(count - 1))) : 0;
+    }
+    const double *begin = points.data();
+    Index upper = Index(std::lower_bound(begin, begin + count, point) - begin);
+    if (upper == 0) {
+        return 0;
+    } else if (upper == count) {
+        return count - 1;
+    }
+    return (point - begin[upper - 1] <= begin[upper] - point) ? upper - 1
+                                                              : upper;
+}
+
+} // namespace signal
+} // namespace soil
@@ -0,0 +1,88 @@
+#ifndef SOIL_SIGNAL_AXIS_HPP
+#define SOIL_SIGNAL_AXIS_HPP
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+#include "soil/signal/spectrum.hpp"
+#include "soil/signal/wavement.hpp"
+
+namespace soil {
+namespace signal {
+
+/**
+ * @brief Axis held either as points or as an implicit uniform grid,
+ *        internal helper of wavement and spectrum
+ *
+ * An axis which is exactly `Sequence::LinSpaced` of its end points is kept
+ * as a grid, and materialized under lock when its points are first read.
+ */
+class Axis {
+public:
+    Axis() = default;
+    Axis(const Axis &other);
+    Axis &operator=(const Axis &other);
+
+    /** Set points, a uniform axis is detected before copy */
+    void assign(const Sequence &points);
+    void assign(Sequence &&points);
+    /** Set uniform grid */
+    void assign(const UniformGrid &grid);
+    /** Shift every point, in O(1) for uniform grid */
+    void shift(double delta);
+
+    /** Get count of points */
+    Size Count() const { return count; }
+    /** Get points, uniform grid is materialized at first call */
+    const Sequence &Points() const;
+    /** Get writable points, uniform grid is materialized and dropped */
+    Sequence &MutablePoints();
+    /** Get uniform grid, nullopt if axis isn't uniform */
+    std::optional<UniformGrid> Grid() const;
+    /** Get point at given index, NaN if index is invalid */
+    double At(Index index) const;
+    /** Get index of nearest point, -1 if axis is empty */
+    Index Nearest(double point) const;
+
+private:
+    /** points, empty while uniform grid isn't materialized */
+    mutable Sequence points;
+    Size count = 0;
+    /** whether axis is held as a uniform grid */
+    bool uniform = false;
+    /** first and last points of uniform grid, and interval */
+    double first = 0.0, last = 0.0, step = 0.0;
+    /** whether `points` is filled, only false for uniform grid */
+    mutable std::atomic<bool> materialized{true};
+    mutable std::mutex mutex;
+
+    void assignGrid(double from, double to, Size n);
+};
+
+/** relative tolerance of intervals of a uniform axis against averaged one */
+constexpr double UNIFORM_TOLERANCE = 1e-6;
+
+/**
+ * @brief Get interval of a uniformly increasing axis, internal helper
+ *
+ * Every point must equal `axis[0] + i * step` within `tolerance * step`,
+ * where `step` is the averaged interval.
+ *
+ * @param [in] axis referee or frequency axis
+ * @param [in] tolerance tolerance of points, relative to interval
+ * @return interval, nullopt if axis is too short, not increasing or not
+ *         uniform
+ */
+std::optional<double>
+uniformStep(const Eigen::Ref<const Sequence, 0, Eigen::InnerStride<>> &axis,
+            double tolerance = UNIFORM_TOLERANCE);
+/** Get interval of uniform referee, read from implicit grid if any */
+std::optional<double> uniformStep(const Wavement &w);
+/** Get interval of uniform frequency axis, read from implicit grid if any */
+std::optional<double> uniformStep(const Spectrum &spec);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_AXIS_HPP
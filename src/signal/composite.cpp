@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "soil/signal/composite.hpp"
+#include "scratch.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** rows evaluated at once by composite signals */
+constexpr Size COMPOSITE_BLOCK = 4096;
+
+std::vector<std::string> wideKeys(const Signal_ptr &lhs,
+                                  const Signal_ptr &rhs) {
+    if (!lhs || !rhs) {
+        throw std::runtime_error("Operand of composite signal is null");
+    }
+    auto lkeys = lhs->Keys(), rkeys = rhs->Keys();
+    return (lkeys.size() >= rkeys.size()) ? lkeys : rkeys;
+}
+
+const Signal_ptr &checked(const Signal_ptr &signal) {
+    if (!signal) {
+        throw std::runtime_error("Operand of composite signal is null");
+    }
+    return signal;
+}
+
+} // namespace
+
+CompositeSignal::CompositeSignal(const std::string &name,
+                                 const std::vector<Signal_ptr> &children,
+                                 const std::vector<std::string> &keys)
+    : Signal(name), children(children), keys(keys) {
+    for (const auto &child : children) {
+        checked(child);
+    }
+}
+
+const std::vector<Signal_ptr> &CompositeSignal::Children() const {
+    return children;
+}
+
+std::vector<std::string> CompositeSignal::Keys() const { return keys; }
+
+Wavement CompositeSignal::get(const Sequence &referee) const {
+    return generate(referee);
+}
+
+SignalSnapshot CompositeSignal::SnapshotAll() const {
+    std::vector<SignalSnapshot> operands;
+    operands.reserve(children.size());
+    for (const auto &child : children) {
+        operands.push_back(child->SnapshotAll());
+    }
+    return SignalSnapshot(Snapshot(), std::move(operands));
+}
+
+void CompositeSignal::evaluate(ConstSequenceRef referee,
+                               Eigen::Ref<Eigen::MatrixXd> values,
+                               const SignalSnapshot &params) const {
+    Size n = referee.size();
+    for (Index pos = 0; pos < n; pos += COMPOSITE_BLOCK) {
+        Size len = std::min(COMPOSITE_BLOCK, n - pos);
+        evaluateBlock(referee.segment(pos, len), values.middleRows(pos, len),
+                      params);
+    }
+}
+
+BinarySignal::BinarySignal(Operation op, const Signal_ptr &lhs,
+                           const Signal_ptr &rhs)
+    : CompositeSignal((op == Sum) ? "sum" : "product", {lhs, rhs},
+                      wideKeys(lhs, rhs)),
+      op(op) {
+    auto lkeys = lhs->Keys(), rkeys = rhs->Keys();
+    lhs_wide = lkeys.size() >= rkeys.size();
+    const auto &wide = lhs_wide ? lkeys : rkeys;
+    const auto &narrow = lhs_wide ? rkeys : lkeys;
+    for (const auto &key : wide) {
+        if (narrow.size() == 1) {
+            mapping.push_back(0);
+        } else {
+            auto it = std::find(narrow.begin(), narrow.end(), key);
+            if ((narrow.size() != wide.size()) || (it == narrow.end())) {
+                throw std::runtime_error(
+                    "Keys of composed signals are not compatible");
+            }
+            mapping.push_back(Index(it - narrow.begin()));
+        }
+    }
+}
+
+BinarySignal::Operation BinarySignal::BinaryOperation() const { return op; }
+
+void BinarySignal::evaluateBlock(ConstSequenceRef referee,
+                                 Eigen::Ref<Eigen::MatrixXd> values,
+                                 const SignalSnapshot &params) const {
+    Index wide_index = lhs_wide ? 0 : 1, narrow_index = 1 - wide_index;
+    const auto &wide = Children()[wide_index];
+    const auto &narrow = Children()[narrow_index];
+    wide->evaluate(referee, values, params.Operand(wide_index));
+    Index count = (mapping.size() > 0)
+                      ? *std::max_element(mapping.begin(), mapping.end()) + 1
+                      : 0;
+    // narrow operand goes to a buffer kept by the thread across blocks
+    Scratch<Eigen::MatrixXd> scratch;
+    auto &buffer = scratch.get();
+    if ((buffer.rows() < referee.size()) || (buffer.cols() < count)) {
+        buffer.resize(std::max(buffer.rows(), referee.size()),
+                      std::max(buffer.cols(), count));
+    }
+    auto other = buffer.topLeftCorner(referee.size(), count);
+    narrow->evaluate(referee, other, params.Operand(narrow_index));
+    // both operations are commutative, so operand order doesn't matter
+    for (Index i = 0; i < Index(mapping.size()); ++i) {
+        if (op == Sum) {
+            values.col(i) += other.col(mapping[i]);
+        } else {
+            values.col(i).array() *= other.col(mapping[i]).array();
+        }
+    }
+}
+
+ScaledSignal::ScaledSignal(const Signal_ptr &signal, double coeff)
+    : CompositeSignal("scaled", {signal}, checked(signal)->Keys()),
+      coeff_id(prepareParameter("coeff", coeff)) {}
+
+void ScaledSignal::evaluateBlock(ConstSequenceRef referee,
+                                 Eigen::Ref<Eigen::MatrixXd> values,
+                                 const SignalSnapshot &params) const {
+    Children()[0]->evaluate(referee, values, params.Operand(0));
+    values *= params.Own().ParameterAs(coeff_id);
+}
+
+OffsetSignal::OffsetSignal(const Signal_ptr &signal, double offset)
+    : CompositeSignal("offset", {signal}, checked(signal)->Keys()),
+      offset_id(prepareParameter("offset", offset)) {}
+
+void OffsetSignal::evaluateBlock(ConstSequenceRef referee,
+                                 Eigen::Ref<Eigen::MatrixXd> values,
+                                 const SignalSnapshot &params) const {
+    Children()[0]->evaluate(referee, values, params.Operand(0));
+    values.array() += params.Own().ParameterAs(offset_id);
+}
+
+Signal_ptr operator+(const Signal_ptr &lhs, const Signal_ptr &rhs) {
+    return std::make_shared<BinarySignal>(BinarySignal::Sum, lhs, rhs);
+}
+
+Signal_ptr operator*(const Signal_ptr &lhs, const Signal_ptr &rhs) {
+    return std::make_shared<BinarySignal>(BinarySignal::Product, lhs, rhs);
+}
+
+Signal_ptr operator*(double coeff, const Signal_ptr &signal) {
+    return std::make_shared<ScaledSignal>(signal, coeff);
+}
+
+Signal_ptr operator*(const Signal_ptr &signal, double coeff) {
+    return std::make_shared<ScaledSignal>(signal, coeff);
+}
+
+Signal_ptr operator+(const Signal_ptr &signal, double offset) {
+    return std::make_shared<OffsetSignal>(signal, offset);
+}
+
+Signal_ptr operator+(double offset, const Signal_ptr &signal) {
+    return std::make_shared<OffsetSignal>(signal, offset);
+}
+
+} // namespace signal
+} // namespace soil
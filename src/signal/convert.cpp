@@ -1,17 +1,127 @@
+#include <algorithm>
+#include <cmath>
 
 #include "soil/signal/convert.hpp"
+#include "soil/signal/fft.hpp"
+#include "axis.hpp"
 
 namespace soil {
 namespace signal {
 
+namespace {
+
+bool hasKey(const std::vector<std::string> &keys, const std::string &key) {
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+/**
+ * @brief Transform a view whose referee is known to be uniform
+ *
+ * @param [in] w view of wavement, its referee isn't read
+ * @param [in] dt interval of referee, >0
+ */
+std::optional<Spectrum> uniformToSpectrum(const WavementView &w, double dt) {
+    // real part from "real", "amp" or the only column, imaginary part from
+    // "imag" column if exists
+    auto keys = w.Keys();
+    std::string real_key;
+    if (hasKey(keys, "real")) {
+        real_key = "real";
+    } else if (hasKey(keys, "amp")) {
+        real_key = "amp";
+    } else if ((keys.size() == 1) && (keys[0] != "imag")) {
+        real_key = keys[0];
+    } else {
+        return std::nullopt;
+    }
+    Size n = w.PointCount();
+    double df = 1.0 / (double(n) * dt);
+    if (!hasKey(keys, "imag")) {
+        // real signal, keep only non-negative half of Hermitian spectrum
+        auto plan = FFTPlanCache::getReal(n);
+        Characteristics values(plan->SpectrumLength());
+        auto column = w.Values(real_key);
+        if (column.innerStride() == 1) {
+            plan->forward(column.data(), values.data());
+        } else {
+            Sequence packed = column;
+            plan->forward(packed.data(), values.data());
+        }
+        return Spectrum(0.0, df, std::move(values), n);
+    }
+    Characteristics x(n);
+    x.real() = w.Values(real_key);
+    x.imag() = w.Values("imag");
+    FFTPlanCache::get(n, FFTPlan::Forward)->execute(x);
+    // shift zero frequency to the center to keep frequency axis increasing
+    Size half = n / 2;
+    Characteristics values(n);
+    values.head(half) = x.tail(half);
+    values.tail(n - half) = x.head(n - half);
+    return Spectrum(-double(half) * df, df, std::move(values));
+}
+
+} // namespace
+
 std::optional<Spectrum> wavementToSpectrum(const Wavement &w) {
-    //todo
-    return std::nullopt;
+    // interval of implicit uniform referee is known without reading it
+    auto grid = w.Grid();
+    if (grid.has_value()) {
+        if (!(grid->step > 0.0)) {
+            return std::nullopt;
+        }
+        // view without referee, so that it's never materialized
+        WavementView view(nullptr, w.PointCount());
+        auto keys = w.Keys();
+        for (Index i = 0; i < Index(keys.size()); ++i) {
+            view.addValues(keys[i], w.ValuesRef(i).data());
+        }
+        return uniformToSpectrum(view, grid->step);
+    }
+    return wavementToSpectrum(WavementView(w));
+}
+
+std::optional<Spectrum> wavementToSpectrum(const WavementView &w) {
+    auto dt = uniformStep(w.Referee());
+    if (!dt.has_value()) {
+        return std::nullopt;
+    }
+    return uniformToSpectrum(w, dt.value());
 }
 
 std::optional<Wavement> spectrumToWavement(const Spectrum &spec) {
-    //todo
-    return std::nullopt;
+    // interval of implicit uniform axis is known without reading it
+    auto df = uniformStep(spec);
+    if (!df.has_value()) {
+        return std::nullopt;
+    }
+    if (spec.HermitianCount() > 0) {
+        Size n = spec.HermitianCount();
+        Sequence x(n);
+        FFTPlanCache::getReal(n)->inverse(spec.Values().data(), x.data());
+        x /= double(n);
+        double dt = 1.0 / (double(n) * df.value());
+        Wavement w(UniformGrid{0.0, dt, n});
+        w.setValues("amp", std::move(x));
+        return w;
+    }
+    // place every point on its bin of discrete fourier transformation
+    Size n = spec.Count();
+    Index k0 = Index(std::llround(spec.FrequencyAt(0) / df.value())) % n;
+    if (k0 < 0) {
+        k0 += n;
+    }
+    const Characteristics &values = spec.Values();
+    Characteristics X(n);
+    X.tail(n - k0) = values.head(n - k0);
+    X.head(k0) = values.tail(k0);
+    FFTPlanCache::get(n, FFTPlan::Inverse)->execute(X);
+    X /= double(n);
+    double dt = 1.0 / (double(n) * df.value());
+    Wavement w(UniformGrid{0.0, dt, n});
+    w.setValues("real", X.real());
+    w.setValues("imag", X.imag());
+    return w;
 }
 
 } // namespace signal
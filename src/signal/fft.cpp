@@ -0,0 +1,594 @@
+#define _USE_MATH_DEFINES
+#include <complex>
+#include <cstdint>
+#include <math.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "soil/signal/fft.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+/** Largest prime radix handled by mixed-radix stages, Bluestein above it */
+const Size MAX_RADIX = 13;
+
+/** complex multiplication without the NaN recovery of std::complex */
+inline Complex cmul(const Complex &a, const Complex &b) {
+    return {a.real() * b.real() - a.imag() * b.imag(),
+            a.real() * b.imag() + a.imag() * b.real()};
+}
+
+/** exp(sign * 2 pi j * k / n) */
+inline Complex twiddle(Size k, Size n, double sign) {
+    return std::polar(1.0, sign * 2.0 * M_PI * double(k % n) / double(n));
+}
+
+/**
+ * All n-th roots of unity, exp(sign * 2 pi j * k / n), stored as a product
+ * of two short tables to avoid O(n) trigonometric calls.
+ */
+class RootTable {
+public:
+    RootTable(Size n, double sign) : n(n), block(1) {
+        while (block * block < n) {
+            ++block;
+        }
+        fine.reserve(block);
+        coarse.reserve(block);
+        for (Size k = 0; k < block; ++k) {
+            fine.push_back(twiddle(k, n, sign));
+            coarse.push_back(twiddle(k * block, n, sign));
+        }
+    }
+
+    Complex operator()(Size k) const {
+        k %= n;
+        return cmul(coarse[k / block], fine[k % block]);
+    }
+
+private:
+    Size n;
+    Size block;
+    std::vector<Complex> fine;
+    std::vector<Complex> coarse;
+};
+
+/**
+ * One pass of the self-sorting (Stockham) decimation-in-frequency algorithm.
+ *
+ * Input is read at x[q + stride * (p + r * m)], output is written at
+ * y[q + stride * (radix * p + k)], where q < stride, p < m, r, k < radix.
+ */
+struct Stage {
+    Size radix;
+    Size stride;
+    Size m;
+    std::vector<Complex> twiddles; /**< twiddles[p * (radix - 1) + k - 1] */
+    std::vector<Complex> roots;    /**< roots of unity for generic radix */
+};
+
+void butterfly2(const Stage &st, const Complex *x, Complex *y) {
+    const Size s = st.stride, m = st.m;
+    for (Size p = 0; p < m; ++p) {
+        const Complex w = st.twiddles[p];
+        const Complex *x0 = x + s * p, *x1 = x + s * (p + m);
+        Complex *y0 = y + s * 2 * p, *y1 = y0 + s;
+        for (Size q = 0; q < s; ++q) {
+            const Complex a = x0[q], b = x1[q];
+            y0[q] = a + b;
+            y1[q] = cmul(a - b, w);
+        }
+    }
+}
+
+template <bool inverse>
+void butterfly3(const Stage &st, const Complex *x, Complex *y) {
+    const Size s = st.stride, m = st.m;
+    const double sn = (inverse ? 0.5 : -0.5) * sqrt(3.0);
+    for (Size p = 0; p < m; ++p) {
+        const Complex w1 = st.twiddles[2 * p], w2 = st.twiddles[2 * p + 1];
+        const Complex *x0 = x + s * p, *x1 = x0 + s * m, *x2 = x1 + s * m;
+        Complex *y0 = y + s * 3 * p, *y1 = y0 + s, *y2 = y1 + s;
+        for (Size q = 0; q < s; ++q) {
+            const Complex a0 = x0[q], t = x1[q] + x2[q], d = x1[q] - x2[q];
+            const Complex base = a0 - 0.5 * t;
+            const Complex rot(-sn * d.imag(), sn * d.real());
+            y0[q] = a0 + t;
+            y1[q] = cmul(base + rot, w1);
+            y2[q] = cmul(base - rot, w2);
+        }
+    }
+}
+
+template <bool inverse>
+void butterfly4(const Stage &st, const Complex *x, Complex *y) {
+    const Size s = st.stride, m = st.m;
+    for (Size p = 0; p < m; ++p) {
+        const Complex *tw = st.twiddles.data() + 3 * p;
+        const Complex w1 = tw[0], w2 = tw[1], w3 = tw[2];
+        const Complex *x0 = x + s * p, *x1 = x0 + s * m, *x2 = x1 + s * m,
+                      *x3 = x2 + s * m;
+        Complex *y0 = y + s * 4 * p, *y1 = y0 + s, *y2 = y1 + s, *y3 = y2 + s;
+        for (Size q = 0; q < s; ++q) {
+            const Complex t0 = x0[q] + x2[q], t1 = x0[q] - x2[q];
+            const Complex t2 = x1[q] + x3[q], d = x1[q] - x3[q];
+            // d * (-j) for forward transformation, d * j for inverse one
+            const Complex t3 = inverse ? Complex(-d.imag(), d.real())
+                                       : Complex(d.imag(), -d.real());
+            y0[q] = t0 + t2;
+            y1[q] = cmul(t1 + t3, w1);
+            y2[q] = cmul(t0 - t2, w2);
+            y3[q] = cmul(t1 - t3, w3);
+        }
+    }
+}
+
+void butterflyGeneric(const Stage &st, const Complex *x, Complex *y) {
+    const Size s = st.stride, m = st.m, r = st.radix;
+    Complex a[MAX_RADIX];
+    for (Size p = 0; p < m; ++p) {
+        const Complex *tw = st.twiddles.data() + (r - 1) * p;
+        for (Size q = 0; q < s; ++q) {
+            for (Size j = 0; j < r; ++j) {
+                a[j] = x[q + s * (p + j * m)];
+            }
+            for (Size k = 0; k < r; ++k) {
+                Complex sum = a[0];
+                for (Size j = 1; j < r; ++j) {
+                    sum += cmul(a[j], st.roots[(j * k) % r]);
+                }
+                y[q + s * (r * p + k)] = (k > 0) ? cmul(sum, tw[k - 1]) : sum;
+            }
+        }
+    }
+}
+
+/**
+ * Transformation kernel of a fixed length and direction
+ *
+ * Twiddle factors of all stages are computed once in constructor, transform
+ * itself is unnormalized.
+ */
+class FFTKernel {
+public:
+    FFTKernel(Size n, bool inverse)
+        : n(n), inverse(inverse), sign(inverse ? 1.0 : -1.0) {
+        if (n <= 1) {
+            // nothing to factor, transform is identity
+            return;
+        }
+        Size rest = n;
+        std::vector<Size> radices;
+        while (rest % 4 == 0) {
+            radices.push_back(4);
+            rest /= 4;
+        }
+        for (Size radix = 2; (radix <= MAX_RADIX) && (rest > 1); ++radix) {
+            while (rest % radix == 0) {
+                radices.push_back(radix);
+                rest /= radix;
+            }
+        }
+        if (rest > 1) {
+            prepareBluestein();
+        } else {
+            prepareStages(radices);
+        }
+    }
+
+    Size Length() const { return n; }
+
+    /** size of scratch buffer needed by `transform` */
+    Size ScratchSize() const {
+        return sub ? (sub->Length() + sub->ScratchSize()) : n;
+    }
+
+    /**
+     * @brief transform data in place
+     *
+     * @param [in,out] data sequence of `n` points
+     * @param [in] scratch buffer with at least `ScratchSize()` points
+     */
+    void transform(Complex *data, Complex *scratch) const {
+        if (sub) {
+            bluestein(data, scratch);
+            return;
+        }
+        Complex *x = data, *y = scratch;
+        for (const auto &st : stages) {
+            switch (st.radix) {
+            case 2:
+                butterfly2(st, x, y);
+                break;
+            case 3:
+                inverse ? butterfly3<true>(st, x, y)
+                        : butterfly3<false>(st, x, y);
+                break;
+            case 4:
+                inverse ? butterfly4<true>(st, x, y)
+                        : butterfly4<false>(st, x, y);
+                break;
+            default:
+                butterflyGeneric(st, x, y);
+                break;
+            }
+            std::swap(x, y);
+        }
+        if (x != data) {
+            std::copy(x, x + n, data);
+        }
+    }
+
+private:
+    void prepareStages(const std::vector<Size> &radices) {
+        Size stride = 1, len = n;
+        RootTable root(n, sign);
+        for (auto radix : radices) {
+            Stage st{radix, stride, len / radix, {}, {}};
+            st.twiddles.reserve(st.m * (radix - 1));
+            for (Size p = 0; p < st.m; ++p) {
+                for (Size k = 1; k < radix; ++k) {
+                    st.twiddles.push_back(root(p * k * stride));
+                }
+            }
+            if (radix > 4) {
+                for (Size k = 0; k < radix; ++k) {
+                    st.roots.push_back(twiddle(k, radix, sign));
+                }
+            }
+            stages.push_back(std::move(st));
+            stride *= radix;
+            len /= radix;
+        }
+    }
+
+    void prepareBluestein() {
+        Size m = 1;
+        while (m < 2 * n - 1) {
+            m <<= 1;
+        }
+        sub = FFTPlanCache::get(m, FFTPlan::Forward);
+        // chirp[k] = exp(sign * pi * j * k^2 / n), k^2 reduced modulo 2n
+        chirp.resize(n);
+        const uint64_t period = uint64_t(2 * n);
+        for (Size k = 0; k < n; ++k) {
+            uint64_t k2 = (uint64_t(k) * uint64_t(k)) % period;
+            chirp[k] = std::polar(1.0, sign * M_PI * double(k2) / double(n));
+        }
+        // spectrum of convolution filter, scaled by 1/m for the inverse step
+        filter.assign(m, Complex(0.0, 0.0));
+        filter[0] = std::conj(chirp[0]);
+        for (Size k = 1; k < n; ++k) {
+            filter[k] = filter[m - k] = std::conj(chirp[k]);
+        }
+        std::vector<Complex> scratch(sub->ScratchSize());
+        sub->execute(filter.data(), scratch.data());
+        for (auto &v : filter) {
+            v /= double(m);
+        }
+    }
+
+    void bluestein(Complex *data, Complex *scratch) const {
+        const Size m = sub->Length();
+        Complex *a = scratch, *sub_scratch = scratch + m;
+        for (Size k = 0; k < n; ++k) {
+            a[k] = cmul(data[k], chirp[k]);
+        }
+        std::fill(a + n, a + m, Complex(0.0, 0.0));
+        sub->execute(a, sub_scratch);
+        // inverse transformation by conjugating a forward one
+        for (Size k = 0; k < m; ++k) {
+            a[k] = std::conj(cmul(a[k], filter[k]));
+        }
+        sub->execute(a, sub_scratch);
+        for (Size k = 0; k < n; ++k) {
+            data[k] = cmul(std::conj(a[k]), chirp[k]);
+        }
+    }
+
+    Size n;
+    bool inverse;
+    double sign;
+    std::vector<Stage> stages;
+    FFTPlan_ptr sub;
+    std::vector<Complex> chirp;
+    std::vector<Complex> filter;
+};
+
+Characteristics transform(const Characteristics &in,
+                          FFTPlan::Direction direction) {
+    Characteristics out = in;
+    if (out.size() > 1) {
+        FFTPlanCache::get(out.size(), direction)->execute(out);
+    }
+    return out;
+}
+
+/**
+ * @brief Scratch buffer of current thread
+ *
+ * @param [in] need count of points
+ * @return buffer with at least `need` points, valid until next call
+ */
+Complex *threadScratch(Size need) {
+    thread_local std::vector<Complex> scratch;
+    if (Size(scratch.size()) < need) {
+        scratch.resize(need);
+    }
+    return scratch.data();
+}
+
+/**
+ * @brief Cached plans of one kind
+ *
+ * Every entry remembers when it's used last, the least recently used one is
+ * dropped when the store is full. Plans still in use stay alive through their
+ * shared pointers.
+ */
+template <typename Key, typename Plan> class PlanLRU {
+public:
+    using Plan_ptr = std::shared_ptr<const Plan>;
+
+    /** get cached plan and mark it as used, null if it isn't cached */
+    Plan_ptr find(const Key &key) {
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        it->second.used = ++tick;
+        return it->second.plan;
+    }
+
+    /** cache plan, an existing one of the same key is kept and returned */
+    Plan_ptr insert(const Key &key, const Plan_ptr &plan) {
+        auto cached = find(key);
+        if (cached) {
+            return cached;
+        }
+        if (Size(entries.size()) >= FFTPlanCache::CAPACITY) {
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.used < oldest->second.used) {
+                    oldest = it;
+                }
+            }
+            entries.erase(oldest);
+        }
+        entries.emplace(key, Entry{plan, ++tick});
+        return plan;
+    }
+
+    Size size() const { return Size(entries.size()); }
+    void clear() { entries.clear(); }
+
+private:
+    struct Entry {
+        Plan_ptr plan;
+        std::uint64_t used;
+    };
+
+    std::map<Key, Entry> entries;
+    std::uint64_t tick = 0;
+};
+
+/** plans of the cache, keyed by length and direction */
+struct PlanStore {
+    std::mutex mutex;
+    PlanLRU<std::pair<Size, FFTPlan::Direction>, FFTPlan> plans;
+    PlanLRU<Size, RealFFTPlan> real_plans;
+};
+
+PlanStore &planStore() {
+    static PlanStore store;
+    return store;
+}
+
+} // namespace
+
+struct FFTPlanPriv {
+    FFTPlan::Direction direction;
+    FFTKernel kernel;
+};
+
+FFTPlan::FFTPlan(Size n, Direction direction)
+    : priv(new FFTPlanPriv{direction,
+                           FFTKernel(n > 0 ? n : 0, direction == Inverse)}) {}
+
+FFTPlan::~FFTPlan() { SAFE_DELETE(priv); }
+
+Size FFTPlan::Length() const { return priv->kernel.Length(); }
+
+FFTPlan::Direction FFTPlan::TransformDirection() const {
+    return priv->direction;
+}
+
+Size FFTPlan::ScratchSize() const { return priv->kernel.ScratchSize(); }
+
+void FFTPlan::execute(Characteristics &data) const {
+    if (data.size() != Length()) {
+        return;
+    }
+    priv->kernel.transform(data.data(), threadScratch(ScratchSize()));
+}
+
+void FFTPlan::execute(std::complex<double> *data,
+                      std::complex<double> *scratch) const {
+    priv->kernel.transform(data, scratch);
+}
+
+struct RealFFTPlanPriv {
+    Size n;
+    /** complex plans of half length for even n, of full length for odd n */
+    FFTPlan_ptr forward;
+    FFTPlan_ptr inverse;
+    /** exp(-2 pi j k / n) for k < n / 2, only for even n */
+    std::vector<Complex> twiddles;
+};
+
+RealFFTPlan::RealFFTPlan(Size n) : priv(new RealFFTPlanPriv{n, {}, {}, {}}) {
+    Size len = ((n >= 2) && (n % 2 == 0)) ? n / 2 : n;
+    priv->forward = FFTPlanCache::get(len, FFTPlan::Forward);
+    priv->inverse = FFTPlanCache::get(len, FFTPlan::Inverse);
+    if (len != n) {
+        RootTable root(n, -1.0);
+        priv->twiddles.reserve(len);
+        for (Size k = 0; k < len; ++k) {
+            priv->twiddles.push_back(root(k));
+        }
+    }
+}
+
+RealFFTPlan::~RealFFTPlan() { SAFE_DELETE(priv); }
+
+Size RealFFTPlan::Length() const { return priv->n; }
+
+Size RealFFTPlan::SpectrumLength() const { return priv->n / 2 + 1; }
+
+void RealFFTPlan::forward(const double *x, std::complex<double> *X) const {
+    const Size n = priv->n, len = priv->forward->Length();
+    Complex *z = threadScratch(len + priv->forward->ScratchSize());
+    if (n == 0) {
+        X[0] = Complex(0.0, 0.0);
+        return;
+    }
+    if (len == n) {
+        for (Size k = 0; k < n; ++k) {
+            z[k] = Complex(x[k], 0.0);
+        }
+        priv->forward->execute(z, z + len);
+        std::copy(z, z + SpectrumLength(), X);
+        return;
+    }
+    // pack even and odd samples as real and imaginary parts
+    for (Size k = 0; k < len; ++k) {
+        z[k] = Complex(x[2 * k], x[2 * k + 1]);
+    }
+    priv->forward->execute(z, z + len);
+    X[0] = Complex(z[0].real() + z[0].imag(), 0.0);
+    X[len] = Complex(z[0].real() - z[0].imag(), 0.0);
+    for (Size k = 1; k < len; ++k) {
+        const Complex a = z[k], b = std::conj(z[len - k]);
+        // spectra of even samples and odd samples
+        const Complex even = 0.5 * (a + b), d = 0.5 * (a - b);
+        const Complex odd(d.imag(), -d.real());
+        X[k] = even + cmul(priv->twiddles[k], odd);
+    }
+}
+
+void RealFFTPlan::inverse(const std::complex<double> *X, double *x) const {
+    const Size n = priv->n, len = priv->inverse->Length();
+    Complex *z = threadScratch(len + priv->inverse->ScratchSize());
+    if (len == n) {
+        const Size half = SpectrumLength();
+        if (n > 0) {
+            z[0] = Complex(X[0].real(), 0.0);
+        }
+        for (Size k = 1; k < half; ++k) {
+            z[k] = X[k];
+            z[n - k] = std::conj(X[k]);
+        }
+        priv->inverse->execute(z, z + len);
+        for (Size k = 0; k < n; ++k) {
+            x[k] = z[k].real();
+        }
+        return;
+    }
+    for (Size k = 0; k < len; ++k) {
+        Complex a = X[k], b = std::conj(X[len - k]);
+        if (k == 0) {
+            a = Complex(a.real(), 0.0);
+            b = Complex(b.real(), 0.0);
+        }
+        const Complex even = a + b;
+        const Complex odd = cmul(a - b, std::conj(priv->twiddles[k]));
+        z[k] = Complex(even.real() - odd.imag(), even.imag() + odd.real());
+    }
+    priv->inverse->execute(z, z + len);
+    for (Size k = 0; k < len; ++k) {
+        x[2 * k] = z[k].real();
+        x[2 * k + 1] = z[k].imag();
+    }
+}
+
+FFTPlan_ptr FFTPlanCache::get(Size n, FFTPlan::Direction direction) {
+    auto &store = planStore();
+    auto key = std::make_pair(n, direction);
+    {
+        std::lock_guard<std::mutex> lock(store.mutex);
+        auto cached = store.plans.find(key);
+        if (cached) {
+            return cached;
+        }
+    }
+    // build outside the lock, Bluestein plans request their sub plan
+    auto plan = std::make_shared<const FFTPlan>(n, direction);
+    std::lock_guard<std::mutex> lock(store.mutex);
+    return store.plans.insert(key, plan);
+}
+
+RealFFTPlan_ptr FFTPlanCache::getReal(Size n) {
+    auto &store = planStore();
+    {
+        std::lock_guard<std::mutex> lock(store.mutex);
+        auto cached = store.real_plans.find(n);
+        if (cached) {
+            return cached;
+        }
+    }
+    auto plan = std::make_shared<const RealFFTPlan>(n);
+    std::lock_guard<std::mutex> lock(store.mutex);
+    return store.real_plans.insert(n, plan);
+}
+
+Size FFTPlanCache::Count() {
+    auto &store = planStore();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    return store.plans.size() + store.real_plans.size();
+}
+
+void FFTPlanCache::clear() {
+    auto &store = planStore();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    store.plans.clear();
+    store.real_plans.clear();
+}
+
+Characteristics fft(const Characteristics &x) {
+    return transform(x, FFTPlan::Forward);
+}
+
+Characteristics ifft(const Characteristics &X) {
+    Characteristics x = transform(X, FFTPlan::Inverse);
+    if (x.size() > 0) {
+        x /= double(x.size());
+    }
+    return x;
+}
+
+Characteristics rfft(const Sequence &x) {
+    auto plan = FFTPlanCache::getReal(x.size());
+    Characteristics X(plan->SpectrumLength());
+    plan->forward(x.data(), X.data());
+    return X;
+}
+
+Sequence irfft(const Characteristics &X, Size n) {
+    if ((n <= 0) || (X.size() != n / 2 + 1)) {
+        return Sequence();
+    }
+    Sequence x(n);
+    FFTPlanCache::getReal(n)->inverse(X.data(), x.data());
+    return x / double(n);
+}
+
+} // namespace signal
+} // namespace soil
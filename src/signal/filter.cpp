@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "soil/signal/filter.hpp"
+#include "soil/util/parallel.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** output values accumulated at once by FIR filter, stay in cache */
+constexpr Size FIR_GRAIN = 2048;
+
+/** count of columns whose recursions are interleaved by biquad filter */
+constexpr int BIQUAD_LANES = 4;
+
+/** filter state of all columns, tied to keys of columns */
+struct FilterState {
+    std::vector<std::string> keys;
+    /** one column of state per column of values */
+    Eigen::MatrixXd values;
+
+    /** get state matching keys of a wavement, reset if keys change */
+    Eigen::MatrixXd &match(const Wavement &w, Size rows) {
+        auto current = w.Keys();
+        if ((current != keys) || (values.rows() != rows)) {
+            keys = current;
+            values = Eigen::MatrixXd::Zero(rows, current.size());
+        }
+        return values;
+    }
+};
+
+} // namespace
+
+struct FIRFilterPriv {
+    Sequence taps;
+    /** last `taps - 1` input samples */
+    FilterState state;
+
+    /** filter values in place, with history of last inputs */
+    void filter(Eigen::MatrixXd &history,
+                Eigen::Ref<Eigen::MatrixXd> values) const {
+        const Size keep = taps.size() - 1, n = values.rows();
+        Eigen::MatrixXd input(keep + n, values.cols());
+        input.topRows(keep) = history;
+        input.bottomRows(n) = values;
+        util::parallelForBlocks(
+            n, values.cols(), FIR_GRAIN,
+            [&](Size begin, Size end, Size col_begin, Size col_end) {
+                Size rows = end - begin, cols = col_end - col_begin;
+                auto out = values.block(begin, col_begin, rows, cols);
+                out = taps[0] *
+                      input.block(keep + begin, col_begin, rows, cols);
+                for (Index k = 1; k <= keep; ++k) {
+                    out += taps[k] *
+                           input.block(keep + begin - k, col_begin, rows, cols);
+                }
+            });
+        history = input.bottomRows(keep);
+    }
+};
+
+FIRFilter::FIRFilter(const Sequence &taps)
+    : Channel("fir_filter"), priv(new FIRFilterPriv{taps, {}}) {
+    if (taps.size() < 1) {
+        SAFE_DELETE(priv);
+        throw std::runtime_error("Empty taps of FIR filter");
+    }
+}
+
+FIRFilter::~FIRFilter() { SAFE_DELETE(priv); }
+
+const Sequence &FIRFilter::Taps() const { return priv->taps; }
+
+Wavement FIRFilter::feed(const Wavement &block) {
+    Wavement post(block);
+    auto &history = priv->state.match(block, priv->taps.size() - 1);
+    priv->filter(history, post.MutableValueMatrix());
+    return post;
+}
+
+void FIRFilter::reset() { priv->state = FilterState(); }
+
+Wavement FIRFilter::via(const Wavement &w) const {
+    Wavement post(w);
+    process(post);
+    return post;
+}
+
+void FIRFilter::process(Wavement &w) const {
+    FilterState state;
+    priv->filter(state.match(w, priv->taps.size() - 1),
+                 w.MutableValueMatrix());
+}
+
+struct BiquadFilterPriv {
+    /** coefficients `[b0, b1, b2, a1, a2]` of sections, divided by a0 */
+    Eigen::Matrix<double, Eigen::Dynamic, 5, Eigen::RowMajor> sections;
+    /** 2 state values per section */
+    FilterState state;
+
+    /**
+     * @brief filter `LANES` columns in place, interleaving their recursions
+     *
+     * @param [in,out] state state of these columns, 2 rows per section
+     * @param [in,out] values columns to filter
+     */
+    template <int LANES>
+    void run(Eigen::Ref<Eigen::MatrixXd> state,
+             Eigen::Ref<Eigen::MatrixXd> values) const {
+        const Size count = sections.rows(), n = values.rows();
+        double *columns[LANES];
+        for (int c = 0; c < LANES; ++c) {
+            columns[c] = values.col(c).data();
+        }
+        std::vector<double> z(2 * count * LANES);
+        for (Index s = 0; s < 2 * count; ++s) {
+            for (int c = 0; c < LANES; ++c) {
+                z[s * LANES + c] = state(s, c);
+            }
+        }
+        for (Index i = 0; i < n; ++i) {
+            double x[LANES];
+            for (int c = 0; c < LANES; ++c) {
+                x[c] = columns[c][i];
+            }
+            for (Index s = 0; s < count; ++s) {
+                const double *k = sections.row(s).data();
+                double *z1 = &z[2 * s * LANES], *z2 = z1 + LANES;
+                for (int c = 0; c < LANES; ++c) {
+                    double y = k[0] * x[c] + z1[c];
+                    z1[c] = k[1] * x[c] - k[3] * y + z2[c];
+                    z2[c] = k[2] * x[c] - k[4] * y;
+                    x[c] = y;
+                }
+            }
+            for (int c = 0; c < LANES; ++c) {
+                columns[c][i] = x[c];
+            }
+        }
+        for (Index s = 0; s < 2 * count; ++s) {
+            for (int c = 0; c < LANES; ++c) {
+                state(s, c) = z[s * LANES + c];
+            }
+        }
+    }
+
+    /** filter values in place, groups of columns run in parallel */
+    void filter(Eigen::MatrixXd &state,
+                Eigen::Ref<Eigen::MatrixXd> values) const {
+        Size columns = values.cols();
+        Size groups = (columns + BIQUAD_LANES - 1) / BIQUAD_LANES;
+        util::parallelFor(groups, 1, [&](Size begin, Size end) {
+            for (Index g = begin; g < end; ++g) {
+                Index first = g * BIQUAD_LANES;
+                Size lanes = std::min(Size(BIQUAD_LANES), columns - first);
+                if (lanes == BIQUAD_LANES) {
+                    run<BIQUAD_LANES>(state.middleCols(first, lanes),
+                                      values.middleCols(first, lanes));
+                } else {
+                    for (Index c = first; c < columns; ++c) {
+                        run<1>(state.middleCols(c, 1), values.middleCols(c, 1));
+                    }
+                }
+            }
+        });
+    }
+};
+
+BiquadFilter::BiquadFilter(const Eigen::MatrixXd &sos)
+    : Channel("biquad_filter"), priv(new BiquadFilterPriv) {
+    if ((sos.rows() < 1) || (sos.cols() != 6) ||
+        (sos.col(3).array() == 0.0).any()) {
+        SAFE_DELETE(priv);
+        throw std::runtime_error("Invalid second-order sections");
+    }
+    priv->sections.resize(sos.rows(), 5);
+    for (Index s = 0; s < sos.rows(); ++s) {
+        double a0 = sos(s, 3);
+        priv->sections.row(s) << sos(s, 0) / a0, sos(s, 1) / a0,
+            sos(s, 2) / a0, sos(s, 4) / a0, sos(s, 5) / a0;
+    }
+}
+
+BiquadFilter::~BiquadFilter() { SAFE_DELETE(priv); }
+
+Size BiquadFilter::SectionCount() const { return priv->sections.rows(); }
+
+Wavement BiquadFilter::feed(const Wavement &block) {
+    Wavement post(block);
+    auto &state = priv->state.match(block, 2 * SectionCount());
+    priv->filter(state, post.MutableValueMatrix());
+    return post;
+}
+
+void BiquadFilter::reset() { priv->state = FilterState(); }
+
+Wavement BiquadFilter::via(const Wavement &w) const {
+    Wavement post(w);
+    process(post);
+    return post;
+}
+
+void BiquadFilter::process(Wavement &w) const {
+    FilterState state;
+    priv->filter(state.match(w, 2 * SectionCount()), w.MutableValueMatrix());
+}
+
+} // namespace signal
+} // namespace soil
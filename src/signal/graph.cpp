@@ -0,0 +1,121 @@
+#include <atomic>
+#include <memory>
+
+#include "soil/signal/graph.hpp"
+#include "soil/util/parallel.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace signal {
+
+struct GraphNode {
+    Graph::NODE_FUNC func;
+    std::vector<int> inputs;
+    /** nodes taking output of this one */
+    std::vector<int> dependents;
+};
+
+class GraphPriv {
+public:
+    std::vector<GraphNode> nodes;
+    std::vector<Wavement> outputs;
+    /** count of inputs not ready yet, valid during run */
+    std::unique_ptr<std::atomic<int>[]> waiting;
+    Wavement empty;
+
+    bool valid(int node) const {
+        return (node >= 0) && (node < int(nodes.size()));
+    }
+
+    int add(const Graph::NODE_FUNC &func, const std::vector<int> &inputs) {
+        int index = int(nodes.size());
+        for (auto input : inputs) {
+            nodes[input].dependents.push_back(index);
+        }
+        nodes.push_back({func, inputs, {}});
+        return index;
+    }
+
+    /** execute a node, then spawn dependents whose inputs are all ready */
+    void execute(int index, util::TaskGroup &group) {
+        const auto &node = nodes[index];
+        std::vector<const Wavement *> inputs;
+        for (auto input : node.inputs) {
+            inputs.push_back(&outputs[input]);
+        }
+        outputs[index] = node.func(inputs);
+        for (auto dependent : node.dependents) {
+            if (waiting[dependent].fetch_sub(1) == 1) {
+                group.run([this, dependent, &group]() {
+                    execute(dependent, group);
+                });
+            }
+        }
+    }
+};
+
+Graph::Graph() : priv(new GraphPriv) {}
+
+Graph::~Graph() { SAFE_DELETE(priv); }
+
+int Graph::addSignal(const Signal_ptr &signal, const Sequence &referee) {
+    if (!signal) {
+        return -1;
+    }
+    return priv->add(
+        [signal, referee](const std::vector<const Wavement *> &) {
+            return signal->get(referee);
+        },
+        {});
+}
+
+int Graph::addProcessor(const Processor_ptr &processor, int input) {
+    if (!processor || !priv->valid(input)) {
+        return -1;
+    }
+    return priv->add(
+        [processor](const std::vector<const Wavement *> &inputs) {
+            return processor->via(*inputs[0]);
+        },
+        {input});
+}
+
+int Graph::addNode(const NODE_FUNC &func, const std::vector<int> &inputs) {
+    if (!func) {
+        return -1;
+    }
+    for (auto input : inputs) {
+        if (!priv->valid(input)) {
+            return -1;
+        }
+    }
+    return priv->add(func, inputs);
+}
+
+int Graph::NodeCount() const { return int(priv->nodes.size()); }
+
+void Graph::run() {
+    int count = NodeCount();
+    priv->outputs.assign(count, Wavement());
+    priv->waiting.reset(new std::atomic<int>[count]);
+    for (int i = 0; i < count; ++i) {
+        priv->waiting[i].store(int(priv->nodes[i].inputs.size()));
+    }
+    util::TaskGroup group;
+    for (int i = 0; i < count; ++i) {
+        if (priv->nodes[i].inputs.empty()) {
+            group.run([this, i, &group]() { priv->execute(i, group); });
+        }
+    }
+    group.wait();
+}
+
+const Wavement &Graph::Output(int node) const {
+    if ((node >= 0) && (node < int(priv->outputs.size()))) {
+        return priv->outputs[node];
+    }
+    return priv->empty;
+}
+
+} // namespace signal
+} // namespace soil
@@ -1,40 +1,294 @@
 
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <mutex>
+#include <stdexcept>
+
+#include "soil/signal/fft.hpp"
 #include "soil/signal/processor.hpp"
+#include "soil/util/parallel.hpp"
+#include "axis.hpp"
+#include "../misc.hpp"
 
 namespace soil {
 namespace signal {
 
+/** values processed by one task */
+constexpr Size PROCESSOR_GRAIN = 16384;
+
+namespace {
+
+/** delay modes of linear channel */
+enum DelayMode { RefereeDelay, GridDelay, SpectralDelay };
+
+/** get delay mode by name, -1 if name is invalid */
+int delayMode(const std::string &name) {
+    if (name == "referee") {
+        return RefereeDelay;
+    } else if (name == "grid") {
+        return GridDelay;
+    } else if (name == "spectral") {
+        return SpectralDelay;
+    }
+    return -1;
+}
+
+/**
+ * @brief delay a column in place by `k` samples and cubic taps, see
+ *        #gridDelay
+ *
+ * Output `i` reads inputs `i - k + 1` down to `i - k - 2` through a window
+ * sliding with it. The column is walked away from the inputs still to be
+ * read, so every input is read before it's overwritten.
+ */
+void lagrangeColumn(double *x, Size n, Index k, const double (&taps)[4]) {
+    auto at = [x, n](Index j) {
+        return ((j >= 0) && (j < n)) ? x[j] : 0.0;
+    };
+    // window[t] is input `i - k + 1 - t`, weighted by tap `t`
+    double window[4];
+    if (k <= 0) {
+        for (int t = 0; t < 4; ++t) {
+            window[t] = at(1 - k - t);
+        }
+        for (Index i = 0; i < n; ++i) {
+            x[i] = taps[0] * window[0] + taps[1] * window[1] +
+                   taps[2] * window[2] + taps[3] * window[3];
+            window[3] = window[2];
+            window[2] = window[1];
+            window[1] = window[0];
+            window[0] = at(i + 2 - k);
+        }
+    } else {
+        for (int t = 0; t < 4; ++t) {
+            window[t] = at(n - k - t);
+        }
+        for (Index i = n - 1; i >= 0; --i) {
+            x[i] = taps[0] * window[0] + taps[1] * window[1] +
+                   taps[2] * window[2] + taps[3] * window[3];
+            window[0] = window[1];
+            window[1] = window[2];
+            window[2] = window[3];
+            window[3] = at(i - k - 3);
+        }
+    }
+}
+
+/**
+ * @brief delay all columns by given samples, keeping their grid
+ *
+ * Input sample `i - k - n` is weighted by cubic Lagrange coefficient of tap
+ * `n` in [-1, 2], where `k` and `f` are integer and fractional parts of
+ * delay. Integer delay is a plain offset copy. Columns are processed in
+ * place and in parallel, without copy of input.
+ */
+void gridDelay(Eigen::Ref<Eigen::MatrixXd> values, double samples) {
+    const Size n = values.rows();
+    double k = std::floor(samples), f = samples - k;
+    if (std::fabs(k) >= double(n)) {
+        values.setZero();
+        return;
+    }
+    double taps[4];
+    for (int t = 0; t < 4; ++t) {
+        taps[t] = 1.0;
+        for (int m = 0; m < 4; ++m) {
+            if (m != t) {
+                taps[t] *= (double(m - 1) - f) / double(m - t);
+            }
+        }
+    }
+    Index shift = Index(k);
+    util::parallelFor(values.cols(), 1, [&](Size begin, Size end) {
+        for (Index c = begin; c < end; ++c) {
+            double *x = values.col(c).data();
+            if (f != 0.0) {
+                lagrangeColumn(x, n, shift, taps);
+            } else if (shift > 0) {
+                std::copy_backward(x, x + n - shift, x + n);
+                std::fill(x, x + shift, 0.0);
+            } else {
+                std::copy(x - shift, x + n, x);
+                std::fill(x + n + shift, x + n, 0.0);
+            }
+        }
+    });
+}
+
+/** delay all columns by given samples with a phase ramp on their spectrum */
+void spectralDelay(Eigen::Ref<Eigen::MatrixXd> values, double samples) {
+    const Size n = values.rows();
+    if (std::fabs(samples) >= double(n)) {
+        values.setZero();
+        return;
+    }
+    // zero padding keeps moved samples from wrapping around
+    Size len = n + Size(std::ceil(std::fabs(samples)));
+    len += len % 2;
+    auto plan = FFTPlanCache::getReal(len);
+    Characteristics ramp(plan->SpectrumLength());
+    for (Index i = 0; i < ramp.size(); ++i) {
+        ramp[i] = std::polar(1.0 / double(len),
+                             -2.0 * M_PI * double(i) * samples / double(len));
+    }
+    util::parallelFor(values.cols(), 1, [&](Size begin, Size end) {
+        Sequence x = Sequence::Zero(len);
+        Characteristics spec(ramp.size());
+        for (Index c = begin; c < end; ++c) {
+            x.head(n) = values.col(c);
+            x.tail(len - n).setZero();
+            plan->forward(x.data(), spec.data());
+            spec.array() *= ramp.array();
+            plan->inverse(spec.data(), x.data());
+            values.col(c) = x.head(n);
+        }
+    });
+}
+
+} // namespace
+
 Processor::Processor(const std::string &name) : util::Parameterized(name) {}
 
+Wavement Processor::viaView(const WavementView &w) const {
+    return via(w.toWavement());
+}
+
+Wavement Processor::viaMoved(Wavement &&w) const {
+    process(w);
+    return std::move(w);
+}
+
+void Processor::process(Wavement &w) const {
+    w = via(static_cast<const Wavement &>(w));
+}
+
 IdealChannel::IdealChannel() : Channel("ideal_channel") {}
 
 Wavement IdealChannel::via(const Wavement &w) const { return w; }
 
-LinearChannel::LinearChannel(double delay, double coeff, double offset)
-    : Channel("linear_channel") {
-    prepareParameter("delay", delay);
-    prepareParameter("coeff", coeff);
-    prepareParameter("offset", offset);
+Wavement IdealChannel::viaView(const WavementView &w) const {
+    return w.toWavement();
+}
+
+void IdealChannel::process(Wavement &) const {}
+
+LinearChannel::LinearChannel(double delay, double coeff, double offset,
+                             const std::string &delay_mode)
+    : Channel("linear_channel"), delay_id(prepareParameter("delay", delay)),
+      coeff_id(prepareParameter("coeff", coeff)),
+      offset_id(prepareParameter("offset", offset)),
+      delay_mode_id(prepareParameter("delay_mode", delay_mode)) {
+    if (delayMode(delay_mode) < 0) {
+        throw std::runtime_error("Invalid delay mode");
+    }
 }
 
 Wavement LinearChannel::via(const Wavement &w) const {
-    double delay = ParameterAs("delay", 0.0), coeff = ParameterAs("coeff", 1.0),
-           offset = ParameterAs("offset", 0.0);
-    auto referee = w.Referee();
+    Wavement post(w);
+    process(post);
+    return post;
+}
+
+Wavement LinearChannel::viaView(const WavementView &w) const {
+    auto params = Snapshot();
+    if (delayMode(params.ParameterAs(delay_mode_id)) != RefereeDelay) {
+        Wavement post = w.toWavement();
+        process(post);
+        return post;
+    }
+    double delay = params.ParameterAs(delay_id),
+           coeff = params.ParameterAs(coeff_id),
+           offset = params.ParameterAs(offset_id);
     auto keys = w.Keys();
-    for (auto &v : referee) {
-        v += delay;
+    Wavement post(Sequence(w.Referee().array() + delay));
+    post.reserveValues(keys.size());
+    for (Index i = 0; i < Index(keys.size()); ++i) {
+        post.setValues(keys[i],
+                       Sequence(w.Values(i).array() * coeff + offset));
     }
-    Wavement post(referee);
-    for (auto key: keys) {
-        Sequence values = w.Values(key);
-        for (auto &v: values) {
-            v = v * coeff + offset;
+    return post;
+}
+
+void LinearChannel::process(Wavement &w) const {
+    auto params = Snapshot();
+    double delay = params.ParameterAs(delay_id),
+           coeff = params.ParameterAs(coeff_id),
+           offset = params.ParameterAs(offset_id);
+    int mode = delayMode(params.ParameterAs(delay_mode_id));
+    std::optional<double> step;
+    if ((mode != RefereeDelay) && (w.PointCount() > 1)) {
+        step = uniformStep(w);
+        if (!step.has_value()) {
+            throw std::runtime_error("Referee isn't uniform for delay mode");
         }
-        post.setValues(key, values);
     }
+    auto values = w.MutableValueMatrix();
+    if (!step.has_value()) {
+        w.shiftReferee(delay);
+    } else if (mode == GridDelay) {
+        gridDelay(values, delay / step.value());
+    } else {
+        spectralDelay(values, delay / step.value());
+    }
+    util::parallelForBlocks(
+        values.rows(), values.cols(), PROCESSOR_GRAIN,
+        [&](Size begin, Size end, Size col_begin, Size col_end) {
+            auto block = values.block(begin, col_begin, end - begin,
+                                      col_end - col_begin);
+            block = block.array() * coeff + offset;
+        });
+}
+
+bool LinearChannel::checkParameter(const std::string &name,
+                                   const std::any &current,
+                                   const std::any &next) const {
+    if (name == "delay_mode") {
+        return (next.type() == typeid(std::string)) &&
+               (delayMode(std::any_cast<std::string>(next)) >= 0);
+    }
+    return Channel::checkParameter(name, current, next);
+}
+
+struct ProcessorChainPriv {
+    std::vector<Processor_ptr> processors;
+    /** guard processors */
+    std::mutex mutex;
+};
+
+ProcessorChain::ProcessorChain(const std::vector<Processor_ptr> &processors)
+    : Processor("processor_chain"), priv(new ProcessorChainPriv) {
+    for (const auto &processor : processors) {
+        append(processor);
+    }
+}
+
+ProcessorChain::~ProcessorChain() { SAFE_DELETE(priv); }
+
+void ProcessorChain::append(const Processor_ptr &processor) {
+    if (processor) {
+        std::lock_guard<std::mutex> lock(priv->mutex);
+        priv->processors.push_back(processor);
+    }
+}
+
+std::vector<Processor_ptr> ProcessorChain::Processors() const {
+    std::lock_guard<std::mutex> lock(priv->mutex);
+    return priv->processors;
+}
+
+Wavement ProcessorChain::via(const Wavement &w) const {
+    Wavement post(w);
+    process(post);
     return post;
 }
 
+void ProcessorChain::process(Wavement &w) const {
+    for (const auto &processor : Processors()) {
+        processor->process(w);
+    }
+}
+
 } // namespace signal
 } // namespace soil
@@ -0,0 +1,530 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "soil/signal/resampler.hpp"
+#include "soil/util/parallel.hpp"
+#include "axis.hpp"
+#include "scratch.hpp"
+#include "../misc.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+/** kernels for AVX2 and AVX-512 are compiled and selected at runtime */
+#define SOIL_RESAMPLER_SIMD
+#endif
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** phases tabulated between input samples by arbitrary resampler */
+constexpr Size ARBITRARY_PHASES = 512;
+/** shape factor of Kaiser window of filter bank */
+constexpr double KAISER_BETA = 8.0;
+/** output values computed by one block of parallel loop */
+constexpr Size RESAMPLER_GRAIN = 16384;
+/** check settings of rational resampler and reduce its ratio */
+Size reduced(Size value, Size up, Size down) {
+    if ((up < 1) || (down < 1)) {
+        throw std::runtime_error("Invalid resampling ratio");
+    }
+    return value / std::gcd(up, down);
+}
+
+/** input and output of a block of output samples of some columns */
+struct Block {
+    /** first input column, rows of input padded by `half` leading zeros */
+    const double *x;
+    /** distance between input columns, and padded row at `x` */
+    Index x_stride, x_from;
+    /** first output column */
+    double *y;
+    /** distance between output columns, and output sample at `y` */
+    Index y_stride, y_from;
+    /** count of columns, first and end of output samples */
+    Index cols, begin, end;
+};
+
+/** row-major matrix of taps */
+using TapMatrix =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/** cache line of taps */
+struct alignas(64) TapLine {
+    double taps[8];
+};
+
+/**
+ * @brief rows of taps from a cache line, so that vector loads of rows of a
+ *        multiple of 8 taps never split across cache lines
+ */
+class TapRows {
+public:
+    void assign(const TapMatrix &rows) {
+        width = rows.cols();
+        lines.resize((rows.size() + 7) / 8);
+        std::copy(rows.data(), rows.data() + rows.size(), data());
+    }
+    const double *row(Index r) const { return data() + r * width; }
+
+private:
+    std::vector<TapLine> lines;
+    Index width = 0;
+
+    double *data() { return reinterpret_cast<double *>(lines.data()); }
+    const double *data() const {
+        return reinterpret_cast<const double *>(lines.data());
+    }
+};
+
+/** stream of blocks fed to resampler */
+struct ResamplerStream {
+    std::vector<std::string> keys;
+    /** referee of first output sample, and output interval */
+    double start = 0.0, interval = 0.0;
+    /** padded input rows kept from row `from`, in `used` rows of buffer */
+    Eigen::MatrixXd buffer;
+    Index from = 0, used = 0;
+    /** next output sample */
+    Index next = 0;
+};
+
+/**
+ * @brief dot product of taps with a window, unrolled if count of taps is
+ *        fixed, taps are `h` or `h + a * d` interpolated between phases
+ */
+template <int TAPS> struct EigenDot {
+    Index taps;
+
+    double operator()(const double *h, const double *x) const {
+        using TapsMap = Eigen::Map<const Eigen::Matrix<double, 1, TAPS>>;
+        return TapsMap(h, taps).dot(TapsMap(x, taps));
+    }
+    double operator()(const double *h, const double *d, double a,
+                      const double *x) const {
+        using TapsMap = Eigen::Map<const Eigen::Matrix<double, 1, TAPS>>;
+        return (TapsMap(h, taps) + a * TapsMap(d, taps))
+            .dot(TapsMap(x, taps));
+    }
+};
+
+#ifdef SOIL_RESAMPLER_SIMD
+/** see `EigenDot`, by AVX2 and FMA, taps are a multiple of 8 */
+template <int TAPS> struct AVX2Dot {
+    Index taps;
+
+    __attribute__((target("avx2,fma"))) double
+    operator()(const double *h, const double *x) const {
+        __m256d even = _mm256_setzero_pd(), odd = _mm256_setzero_pd();
+        for (Index t = 0; t < count(); t += 8) {
+            even = _mm256_fmadd_pd(_mm256_loadu_pd(h + t),
+                                   _mm256_loadu_pd(x + t), even);
+            odd = _mm256_fmadd_pd(_mm256_loadu_pd(h + t + 4),
+                                  _mm256_loadu_pd(x + t + 4), odd);
+        }
+        return sum(even, odd);
+    }
+    __attribute__((target("avx2,fma"))) double
+    operator()(const double *h, const double *d, double a,
+               const double *x) const {
+        __m256d even = _mm256_setzero_pd(), odd = _mm256_setzero_pd();
+        __m256d scale = _mm256_set1_pd(a);
+        for (Index t = 0; t < count(); t += 8) {
+            __m256d lower = _mm256_fmadd_pd(scale, _mm256_loadu_pd(d + t),
+                                            _mm256_loadu_pd(h + t));
+            __m256d upper = _mm256_fmadd_pd(
+                scale, _mm256_loadu_pd(d + t + 4), _mm256_loadu_pd(h + t + 4));
+            even = _mm256_fmadd_pd(lower, _mm256_loadu_pd(x + t), even);
+            odd = _mm256_fmadd_pd(upper, _mm256_loadu_pd(x + t + 4), odd);
+        }
+        return sum(even, odd);
+    }
+    /** count of taps, known at compile time if fixed */
+    Index count() const { return (TAPS == Eigen::Dynamic) ? taps : TAPS; }
+    __attribute__((target("avx2,fma"))) static double sum(__m256d even,
+                                                          __m256d odd) {
+        __m256d all = _mm256_add_pd(even, odd);
+        __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(all),
+                                  _mm256_extractf128_pd(all, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+};
+
+/** see `EigenDot`, by AVX-512, taps are a multiple of 8 */
+template <int TAPS> struct AVX512Dot {
+    Index taps;
+
+    __attribute__((target("avx512f"))) double
+    operator()(const double *h, const double *x) const {
+        __m512d sum = _mm512_setzero_pd();
+        for (Index t = 0; t < count(); t += 8) {
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(h + t),
+                                  _mm512_loadu_pd(x + t), sum);
+        }
+        return _mm512_reduce_add_pd(sum);
+    }
+    __attribute__((target("avx512f"))) double
+    operator()(const double *h, const double *d, double a,
+               const double *x) const {
+        __m512d sum = _mm512_setzero_pd(), scale = _mm512_set1_pd(a);
+        for (Index t = 0; t < count(); t += 8) {
+            __m512d taps = _mm512_fmadd_pd(scale, _mm512_loadu_pd(d + t),
+                                           _mm512_loadu_pd(h + t));
+            sum = _mm512_fmadd_pd(taps, _mm512_loadu_pd(x + t), sum);
+        }
+        return _mm512_reduce_add_pd(sum);
+    }
+    /** count of taps, known at compile time if fixed */
+    Index count() const { return (TAPS == Eigen::Dynamic) ? taps : TAPS; }
+};
+#endif
+
+} // namespace
+
+struct ResamplerPriv {
+    Size phases;
+    double step;
+    bool exact;
+    Size half;
+    /** one row of `2 * half` taps per phase, plus one for interpolation */
+    TapRows bank;
+    /** difference of every row of bank to the next one, if not exact */
+    TapRows slopes;
+    /** count of phases is `1 << phase_bits` if not exact */
+    int phase_bits = 0;
+    /** state of stream fed block by block */
+    ResamplerStream stream;
+#ifdef SOIL_RESAMPLER_SIMD
+    /** whether processor supports AVX2 and FMA, and AVX-512 */
+    bool avx2 =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    bool avx512 = __builtin_cpu_supports("avx512f");
+#endif
+
+    ResamplerPriv(Size phases, double step, bool exact, Size half)
+        : phases(phases), step(step), exact(exact), half(half) {}
+
+    /** tabulate Kaiser windowed sinc on every phase */
+    void design(double cutoff) {
+        Size taps = 2 * half;
+        double ratio = double(phases) / step;
+        double fc = cutoff * std::min(1.0, ratio);
+        double norm = 1.0 / std::cyl_bessel_i(0.0, KAISER_BETA);
+        auto kaiser = [norm](double r) {
+            return (std::fabs(r) < 1.0)
+                       ? std::cyl_bessel_i(0.0, KAISER_BETA *
+                                                    std::sqrt(1.0 - r * r)) *
+                             norm
+                       : 0.0;
+        };
+        TapMatrix rows(phases + 1, taps);
+        for (Index p = 0; p <= phases; ++p) {
+            for (Index t = 0; t < taps; ++t) {
+                // distance from input tap to output position, in samples
+                double tau = double(p) / double(phases) - double(t - half + 1);
+                double x = M_PI * fc * tau;
+                double sinc = (x == 0.0) ? 1.0 : std::sin(x) / x;
+                rows(p, t) = fc * sinc * kaiser(tau / double(half));
+            }
+            rows.row(p) /= rows.row(p).sum();
+        }
+        bank.assign(rows);
+        if (!exact) {
+            slopes.assign(rows.bottomRows(phases) - rows.topRows(phases));
+            while ((Size(1) << phase_bits) < phases) {
+                ++phase_bits;
+            }
+        }
+    }
+
+    /**
+     * @brief get input base of an output sample, its window starts at row
+     *        `base + 1` of input padded by `half` zeros at both ends
+     */
+    Index baseOf(Index j) const {
+        return exact ? Index(Size(j) * Size(step) / phases)
+                     : Index(double(j) * step / double(phases));
+    }
+
+    /**
+     * @brief compute a range of output samples of some columns
+     *
+     * Taps of common sizes are unrolled at compile time, and multiples of 8
+     * taps use AVX-512, or AVX2 and FMA, where the processor supports them.
+     *
+     * @param [in] block input and output of samples to compute
+     */
+    void run(const Block &block) const {
+#ifdef SOIL_RESAMPLER_SIMD
+        if ((avx512 || avx2) && (half % 4 == 0)) {
+            switch (2 * half) {
+            case 16:
+                return runSIMD<16>(block);
+            case 32:
+                return runSIMD<32>(block);
+            default:
+                return runSIMD<Eigen::Dynamic>(block);
+            }
+        }
+#endif
+        switch (2 * half) {
+        case 8:
+            return runWith(block, EigenDot<8>{8});
+        case 16:
+            return runWith(block, EigenDot<16>{16});
+        case 32:
+            return runWith(block, EigenDot<32>{32});
+        default:
+            return runWith(block, EigenDot<Eigen::Dynamic>{2 * half});
+        }
+    }
+
+#ifdef SOIL_RESAMPLER_SIMD
+    /** see `run`, by widest vectors the processor supports */
+    template <int TAPS> void runSIMD(const Block &block) const {
+        if (avx512) {
+            runAVX512(block, AVX512Dot<TAPS>{2 * half});
+        } else {
+            runAVX2(block, AVX2Dot<TAPS>{2 * half});
+        }
+    }
+    /** see `run`, compiled for AVX2 and FMA with every call inlined */
+    template <typename Dot>
+    __attribute__((target("avx2,fma"), flatten)) void
+    runAVX2(const Block &block, const Dot &dot) const {
+        runWith(block, dot);
+    }
+    /** see `run`, compiled for AVX-512 with every call inlined */
+    template <typename Dot>
+    __attribute__((target("avx512f"), flatten)) void
+    runAVX512(const Block &block, const Dot &dot) const {
+        runWith(block, dot);
+    }
+#endif
+
+    /** see `run`, with dot product of a window by `dot` */
+    template <typename Dot>
+    void runWith(const Block &b, const Dot &dot) const {
+        for (Index c = 0; c < b.cols; ++c) {
+            // window of input base `i` starts at `x + i + shift`
+            const double *x = b.x + c * b.x_stride;
+            double *y = b.y + c * b.y_stride;
+            Index shift = 1 - b.x_from;
+            if (exact) {
+                runExact(x, shift, y, b, dot);
+            } else {
+                runArbitrary(x, shift, y, b, dot);
+            }
+        }
+    }
+
+    /** see `run`, one column of exact resampler */
+    template <typename Dot>
+    void runExact(const double *x, Index shift, double *y, const Block &b,
+                  const Dot &dot) const {
+        // advance input base and phase incrementally
+        Size s = Size(step), jump = s / phases, rest = s % phases;
+        Index base = baseOf(b.begin), phase = b.begin * s % phases;
+        for (Index j = b.begin; j < b.end; ++j) {
+            y[j - b.y_from] = dot(bank.row(phase), x + (base + shift));
+            base += jump;
+            phase += rest;
+            if (phase >= phases) {
+                phase -= phases;
+                ++base;
+            }
+        }
+    }
+
+    /** see `run`, one column of arbitrary resampler */
+    template <typename Dot>
+    void runArbitrary(const double *x, Index shift, double *y,
+                      const Block &b, const Dot &dot) const {
+        // position relative to input base of the first output, in fixed
+        // point with every fractional bit the block leaves, so that outputs
+        // depend on each other by one integer addition, irregular wraps of
+        // phases cause no branch, and base, phase and weight are shifted
+        // out of position
+        Index first = baseOf(b.begin);
+        double start =
+            double(b.begin) * step / double(phases) - double(first);
+        double span = double(b.end - b.begin) * step / double(phases) + 2.0;
+        int bits = 62 - int(std::ceil(std::log2(span)));
+        int weight_bits = bits - phase_bits;
+        double scale = std::ldexp(1.0, bits);
+        std::uint64_t position = std::uint64_t(std::max(start, 0.0) * scale),
+                      increment = std::uint64_t(
+                          std::round(step / double(phases) * scale)),
+                      phase_mask = phases - 1,
+                      weight_mask = (std::uint64_t(1) << weight_bits) - 1;
+        double unit = std::ldexp(1.0, -weight_bits);
+        for (Index j = b.begin; j < b.end; ++j) {
+            Index base = first + Index(position >> bits);
+            Index phase = Index((position >> weight_bits) & phase_mask);
+            double a = double(position & weight_mask) * unit;
+            y[j - b.y_from] = dot(bank.row(phase), slopes.row(phase), a,
+                                  x + (base + shift));
+            position += increment;
+        }
+    }
+};
+
+Resampler::Resampler(const std::string &name, Size phases, double step,
+                     bool exact, Size half_taps, double cutoff)
+    : Processor(name),
+      priv(new ResamplerPriv(phases, step, exact, half_taps)) {
+    if ((phases < 1) || !(step > 0.0) || (half_taps < 1) ||
+        !(cutoff > 0.0) || (cutoff > 1.0) ||
+        (exact && (step != std::floor(step))) ||
+        (!exact && ((phases & (phases - 1)) != 0))) {
+        SAFE_DELETE(priv);
+        throw std::runtime_error("Invalid resampler settings");
+    }
+    priv->design(cutoff);
+}
+
+Resampler::~Resampler() { SAFE_DELETE(priv); }
+
+double Resampler::Ratio() const { return double(priv->phases) / priv->step; }
+
+Size Resampler::Taps() const { return 2 * priv->half; }
+
+Wavement Resampler::via(const Wavement &w) const {
+    if (w.PointCount() < 2) {
+        return w;
+    }
+    auto dt = uniformStep(w);
+    if (!dt.has_value()) {
+        throw std::runtime_error("Referee isn't uniform for resampling");
+    }
+    const Size n = w.PointCount(), half = priv->half, taps = 2 * half;
+    const Size phases = priv->phases;
+    const double step = priv->step;
+    // outputs cover input span
+    Size m = 0;
+    if (priv->exact) {
+        m = (n - 1) * phases / Size(step) + 1;
+    } else {
+        m = Size(std::floor(double(n - 1) * double(phases) / step + 1e-9)) + 1;
+    }
+    auto values = w.ValueMatrix();
+    Eigen::MatrixXd output(m, values.cols());
+    util::parallelForBlocks(
+        m, values.cols(), RESAMPLER_GRAIN,
+        [&](Size begin, Size end, Size col_begin, Size col_end) {
+            // rows of input padded by zeros, read by windows of the block,
+            // copied into a scratch of current thread staying in cache
+            Index from = priv->baseOf(begin) + 1;
+            Index rows = priv->baseOf(end - 1) + taps + 1 - from;
+            Index cols = col_end - col_begin;
+            Scratch<Sequence> scratch;
+            Sequence &buffer = scratch.get();
+            if (buffer.size() < rows * cols) {
+                buffer.resize(rows * cols);
+            }
+            Eigen::Map<Eigen::MatrixXd> padded(buffer.data(), rows, cols);
+            // padded row `r` holds input row `r - half`
+            Index first = std::max(from, Index(half)),
+                  last = std::min(from + rows, Index(n + half));
+            Index head = std::max(Index(0), first - from),
+                  body = std::max(Index(0), last - first);
+            padded.topRows(head).setZero();
+            padded.middleRows(head, body) =
+                values.block(first - half, col_begin, body, cols);
+            padded.bottomRows(rows - head - body).setZero();
+            priv->run(Block{padded.data(), rows, from,
+                            output.col(col_begin).data(), output.rows(), 0,
+                            cols, Index(begin), Index(end)});
+        });
+    Wavement post(UniformGrid{w.RefereeAt(0), dt.value() * step / phases, m});
+    post.setValues(w.Keys(), std::move(output));
+    return post;
+}
+
+Wavement Resampler::feed(const Wavement &block) {
+    auto dt = uniformStep(block);
+    if (!dt.has_value()) {
+        throw std::runtime_error("Block isn't uniform for resampling");
+    }
+    const Index half = priv->half, n = block.PointCount();
+    auto &s = priv->stream;
+    auto keys = block.Keys();
+    if ((keys != s.keys) || !(s.interval > 0.0)) {
+        // a new stream starts by `half` padded zeros
+        s = ResamplerStream();
+        s.keys = keys;
+        s.start = block.RefereeAt(0);
+        s.interval = dt.value() * priv->step / double(priv->phases);
+        s.buffer = Eigen::MatrixXd::Zero(half + n, keys.size());
+        s.used = half;
+    }
+    auto values = block.ValueMatrix();
+    const Index cols = values.cols();
+    if (s.used + n > s.buffer.rows()) {
+        Eigen::MatrixXd grown(s.used + n, cols);
+        grown.topRows(s.used) = s.buffer.topRows(s.used);
+        s.buffer.swap(grown);
+    }
+    s.buffer.middleRows(s.used, n) = values;
+    s.used += n;
+    // output samples whose windows are fed, i.e. of bases up to `last`
+    Index rows = s.from + s.used, last = rows - 2 * half - 1;
+    Index end = s.next;
+    if (last >= 0) {
+        end = std::max(s.next,
+                       Index(std::ceil(double(last + 1) *
+                                       double(priv->phases) / priv->step)));
+        while ((end > s.next) && (priv->baseOf(end - 1) > last)) {
+            --end;
+        }
+        while (priv->baseOf(end) <= last) {
+            ++end;
+        }
+    }
+    Eigen::MatrixXd output(end - s.next, cols);
+    util::parallelForBlocks(
+        end - s.next, cols, RESAMPLER_GRAIN,
+        [&](Size begin, Size stop, Size col_begin, Size col_end) {
+            priv->run(Block{s.buffer.col(col_begin).data(), s.buffer.rows(),
+                            s.from, output.col(col_begin).data(),
+                            output.rows(), s.next, Index(col_end - col_begin),
+                            s.next + Index(begin), s.next + Index(stop)});
+        });
+    // keep padded rows from window of next output sample
+    Index from = std::min(priv->baseOf(end) + 1, rows);
+    Index drop = from - s.from;
+    for (Index c = 0; c < cols; ++c) {
+        double *column = s.buffer.col(c).data();
+        std::copy(column + drop, column + s.used, column);
+    }
+    s.used -= drop;
+    s.from = from;
+    Wavement post(UniformGrid{s.start + double(s.next) * s.interval,
+                              s.interval, Size(end - s.next)});
+    post.setValues(keys, std::move(output));
+    s.next = end;
+    return post;
+}
+
+void Resampler::reset() { priv->stream = ResamplerStream(); }
+
+RationalResampler::RationalResampler(Size up, Size down, Size half_taps,
+                                     double cutoff)
+    : Resampler("rational_resampler", reduced(up, up, down),
+                double(reduced(down, up, down)), true, half_taps, cutoff) {}
+
+ArbitraryResampler::ArbitraryResampler(double ratio, Size half_taps,
+                                       double cutoff)
+    : Resampler("arbitrary_resampler", ARBITRARY_PHASES,
+                (ratio > 0.0) ? double(ARBITRARY_PHASES) / ratio : 0.0, false,
+                half_taps, cutoff) {}
+
+} // namespace signal
+} // namespace soil
@@ -0,0 +1,55 @@
+#ifndef SOIL_SIGNAL_SCRATCH_HPP
+#define SOIL_SIGNAL_SCRATCH_HPP
+
+#include <cstddef>
+#include <deque>
+
+namespace soil {
+namespace signal {
+
+/**
+ * @brief Scratch buffer of current thread, kept for later evaluations
+ *
+ * Buffers of a thread are stacked by nesting: an evaluation nested in
+ * another one on the same thread, e.g. of an operand or of a task executed
+ * while waiting, takes the next buffer, so a buffer is never shared by two
+ * evaluations in progress. Buffers keep their storage, so evaluations in
+ * steady state don't allocate.
+ *
+ * @tparam Buffer type of buffer, default constructible
+ */
+template <typename Buffer> class Scratch {
+public:
+    Scratch() : depth(level()++) {
+        auto &buffers = pool();
+        if (buffers.size() <= depth) {
+            buffers.emplace_back();
+        }
+    }
+    ~Scratch() { --level(); }
+
+    Scratch(const Scratch &) = delete;
+    Scratch &operator=(const Scratch &) = delete;
+
+    /** Get buffer, valid as long as this guard */
+    Buffer &get() { return pool()[depth]; }
+
+private:
+    /** buffers of current thread, deque keeps them in place while growing */
+    static std::deque<Buffer> &pool() {
+        static thread_local std::deque<Buffer> buffers;
+        return buffers;
+    }
+    /** count of guards alive on current thread */
+    static std::size_t &level() {
+        static thread_local std::size_t count = 0;
+        return count;
+    }
+
+    std::size_t depth;
+};
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_SCRATCH_HPP
@@ -1,9 +1,13 @@
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <functional>
 #include <math.h>
 #include <unordered_map>
 
 #include "soil/signal/signal.hpp"
+#include "soil/util/parallel.hpp"
+#include "scratch.hpp"
+#include "tone.hpp"
 #include "../misc.hpp"
 
 using namespace soil::util;
@@ -11,18 +15,84 @@ using namespace soil::util;
 namespace soil {
 namespace signal {
 
+/** values generated by one task, referee points times columns */
+constexpr Size SIGNAL_GRAIN = 16384;
+
+SignalSnapshot::SignalSnapshot(util::ParameterSnapshot &&own,
+                               std::vector<SignalSnapshot> &&operands)
+    : own(std::move(own)), operands(std::move(operands)) {}
+
+const util::ParameterSnapshot &SignalSnapshot::Own() const { return own; }
+
+const SignalSnapshot &SignalSnapshot::Operand(Index index) const {
+    return operands.at(index);
+}
+
 Signal::Signal(const std::string &name) : Parameterized(name) {}
 
+SignalSnapshot Signal::SnapshotAll() const {
+    return SignalSnapshot(Snapshot());
+}
+
+Wavement Signal::getOn(const WavementView &view) const {
+    return get(Sequence(view.Referee()));
+}
+
+void Signal::evaluate(ConstSequenceRef referee,
+                      Eigen::Ref<Eigen::MatrixXd> values,
+                      const SignalSnapshot &) const {
+    auto w = get(Sequence(referee));
+    auto keys = Keys();
+    for (Index i = 0; i < Index(keys.size()); ++i) {
+        auto column = w.ValuesRef(keys[i]);
+        if (column.size() == values.rows()) {
+            values.col(i) = column;
+        }
+    }
+}
+
+Wavement Signal::generate(const Sequence &referee) const {
+    Wavement w(referee);
+    auto keys = Keys();
+    Eigen::MatrixXd values(referee.size(), keys.size());
+    auto params = SnapshotAll();
+    // all columns are evaluated together, so wide signals take fewer rows
+    Size grain = SIGNAL_GRAIN / std::max(Size(1), Size(keys.size()));
+    parallelFor(referee.size(), grain, [&](Size begin, Size end) {
+        evaluate(referee.segment(begin, end - begin),
+                 values.middleRows(begin, end - begin), params);
+    });
+    w.setValues(keys, std::move(values));
+    return w;
+}
+
 struct FunctionalSignalPriv {
-    std::unordered_map<std::string, std::function<double(double)>> functions;
+    /** keys and block functions, per-point functions are wrapped */
+    std::vector<std::pair<std::string, FunctionalSignal::BLOCK_FUNC>>
+        functions;
 };
 
 FunctionalSignal::FunctionalSignal(
     const std::unordered_map<std::string, SIG_FUNC> &functions)
     : Signal("functional"), priv(new FunctionalSignalPriv) {
-    for (auto [key, func] : functions) {
-        if (key.size() > 0) {
-            priv->functions[key] = func;
+    for (const auto &[key, func] : functions) {
+        if ((key.size() > 0) && func) {
+            priv->functions.emplace_back(
+                key, [func](const Sequence &referee, Eigen::Ref<Sequence> out) {
+                    for (Index i = 0; i < referee.size(); ++i) {
+                        out[i] = func(referee[i]);
+                    }
+                });
+        }
+    }
+}
+
+FunctionalSignal::FunctionalSignal(
+    const std::unordered_map<std::string, BLOCK_FUNC> &functions)
+    : Signal("functional"), priv(new FunctionalSignalPriv) {
+    for (const auto &[key, func] : functions) {
+        if ((key.size() > 0) && func) {
+            priv->functions.emplace_back(key, func);
         }
     }
 }
@@ -32,115 +102,118 @@ FunctionalSignal::~FunctionalSignal() { SAFE_DELETE(priv); }
 std::vector<std::string> FunctionalSignal::Keys() const {
     std::vector<std::string> keys;
     keys.reserve(priv->functions.size());
-    for (auto [key, _] : priv->functions) {
-        keys.push_back(key);
+    for (const auto &pair : priv->functions) {
+        keys.push_back(pair.first);
     }
     return keys;
 }
 
 Wavement FunctionalSignal::get(const Sequence &referee) const {
-    Wavement w(referee);
-    for (auto [key, func] : priv->functions) {
-        Sequence values = referee;
-        for (double &val : values) {
-            val = func(val);
-        }
-        w.setValues(key, values);
-    }
-    return w;
+    return generate(referee);
 }
 
-FixedSignal::FixedSignal(double level) : Signal("fixed") {
-    prepareParameter("level", level);
+void FunctionalSignal::evaluate(ConstSequenceRef referee,
+                                Eigen::Ref<Eigen::MatrixXd> values,
+                                const SignalSnapshot &) const {
+    // copy referee into a buffer kept by the thread, for block functions
+    Scratch<Sequence> scratch;
+    Sequence &points = scratch.get();
+    points = referee;
+    for (Index i = 0; i < Index(priv->functions.size()); ++i) {
+        priv->functions[i].second(points, values.col(i));
+    }
 }
 
+FixedSignal::FixedSignal(double level)
+    : Signal("fixed"), level_id(prepareParameter("level", level)) {}
+
 std::vector<std::string> FixedSignal::Keys() const { return {"amp"}; }
 
 Wavement FixedSignal::get(const Sequence &referee) const {
-    Wavement w(referee);
-    w.setValues("amp",
-                Sequence::Ones(referee.size()) * ParameterAs("level", 0.0));
-    return w;
+    return generate(referee);
 }
 
-LinearSignal::LinearSignal(double coeff, double offset) : Signal("linear") {
-    prepareParameter("coeff", coeff);
-    prepareParameter("offset", offset);
+void FixedSignal::evaluate(ConstSequenceRef,
+                           Eigen::Ref<Eigen::MatrixXd> values,
+                           const SignalSnapshot &params) const {
+    values.col(0).setConstant(params.Own().ParameterAs(level_id));
 }
 
+LinearSignal::LinearSignal(double coeff, double offset)
+    : Signal("linear"), coeff_id(prepareParameter("coeff", coeff)),
+      offset_id(prepareParameter("offset", offset)) {}
+
 std::vector<std::string> LinearSignal::Keys() const { return {"amp"}; }
 
 Wavement LinearSignal::get(const Sequence &referee) const {
-    Wavement w(referee);
-    double coeff = ParameterAs("coeff", 1.0),
-           offset = ParameterAs("offset", 0.0);
-    Sequence values = referee;
-    for (double &value : values) {
-        value = value * coeff + offset;
-    }
-    w.setValues("amp", values);
-    return w;
+    return generate(referee);
 }
 
-PeriodicalSignal::PeriodicalSignal(const std::string &name, double freq)
-    : Signal(name) {
-    prepareParameter("freq", freq);
+void LinearSignal::evaluate(ConstSequenceRef referee,
+                            Eigen::Ref<Eigen::MatrixXd> values,
+                            const SignalSnapshot &snapshot) const {
+    const auto &params = snapshot.Own();
+    double coeff = params.ParameterAs(coeff_id),
+           offset = params.ParameterAs(offset_id);
+    values.col(0) = referee.array() * coeff + offset;
 }
 
+PeriodicalSignal::PeriodicalSignal(const std::string &name, double freq)
+    : Signal(name), freq_id(prepareParameter("freq", freq)) {}
+
 SineSignal::SineSignal(double freq, double phase, double A, double offset)
-    : PeriodicalSignal("sine", freq) {
-    prepareParameter("phase", phase);
-    prepareParameter("A", A);
-    prepareParameter("offset", offset);
-}
+    : PeriodicalSignal("sine", freq),
+      phase_id(prepareParameter("phase", phase)),
+      A_id(prepareParameter("A", A)),
+      offset_id(prepareParameter("offset", offset)) {}
 
 std::vector<std::string> SineSignal::Keys() const { return {"amp"}; }
 
 Wavement SineSignal::get(const Sequence &referee) const {
-    Wavement w(referee);
-    double omega = 2.0 * M_PI * ParameterAs("freq", 50.0),
-           phase = ParameterAs("phase", 0.0), A = ParameterAs("A", 1.0),
-           offset = ParameterAs("offset", 0.0);
-    Sequence values = referee;
-    for (double &value : values) {
-        value = A * sin(omega * value + phase) + offset;
-    }
-    w.setValues("amp", values);
-    return w;
+    return generate(referee);
 }
 
-ComplexSineSignal::ComplexSineSignal(double freq, double phase, double A)
-    : PeriodicalSignal("complex_sine", freq) {
-    prepareParameter("phase", phase);
-    prepareParameter("A", A);
+void SineSignal::evaluate(ConstSequenceRef referee,
+                          Eigen::Ref<Eigen::MatrixXd> values,
+                          const SignalSnapshot &snapshot) const {
+    const auto &params = snapshot.Own();
+    double omega = 2.0 * M_PI * params.ParameterAs(freq_id),
+           phase = params.ParameterAs(phase_id), A = params.ParameterAs(A_id),
+           offset = params.ParameterAs(offset_id);
+    auto amp = values.col(0);
+    toneSinCos(referee, omega, phase, amp.data(), nullptr);
+    amp = A * amp.array() + offset;
 }
 
+ComplexSineSignal::ComplexSineSignal(double freq, double phase, double A)
+    : PeriodicalSignal("complex_sine", freq),
+      phase_id(prepareParameter("phase", phase)),
+      A_id(prepareParameter("A", A)) {}
+
 std::vector<std::string> ComplexSineSignal::Keys() const {
     return {"real", "imag"};
 }
 
 Wavement ComplexSineSignal::get(const Sequence &referee) const {
-    Wavement w(referee);
-    double omega = 2.0 * M_PI * ParameterAs("freq", 50.0),
-           phase = ParameterAs("phase", 0.0), A = ParameterAs("A", 1.0);
-    Sequence real = referee, imag = referee;
-    for (double &value : real) {
-        value = A * cos(omega * value + phase);
-    }
-    for (double &value : imag) {
-        value = A * sin(omega * value + phase);
-    }
-    w.setValues("real", real);
-    w.setValues("imag", imag);
-    return w;
+    return generate(referee);
 }
 
-PulseSignal::PulseSignal(const std::string &name, double begin, double duration)
-    : Signal(name) {
-    prepareParameter("begin", begin);
-    prepareParameter("duration", ((duration > 0.0) ? duration : 1.0));
+void ComplexSineSignal::evaluate(ConstSequenceRef referee,
+                                 Eigen::Ref<Eigen::MatrixXd> values,
+                                 const SignalSnapshot &snapshot) const {
+    const auto &params = snapshot.Own();
+    double omega = 2.0 * M_PI * params.ParameterAs(freq_id),
+           phase = params.ParameterAs(phase_id), A = params.ParameterAs(A_id);
+    toneSinCos(referee, omega, phase, values.col(1).data(),
+               values.col(0).data());
+    values *= A;
 }
 
+PulseSignal::PulseSignal(const std::string &name, double begin, double duration)
+    : Signal(name), begin_id(prepareParameter("begin", begin)),
+      duration_id(prepareParameter("duration",
+                                   ((duration > 0.0) ? duration : 1.0))) {}
+
 bool PulseSignal::checkParameter(const std::string &name,
                                  const std::any &current,
                                  const std::any &next) const {
@@ -1,51 +1,65 @@
 #include <stdexcept>
 
 #include "soil/signal/spectrum.hpp"
+#include "axis.hpp"
 #include "../misc.hpp"
 
 namespace soil {
 namespace signal {
 
 struct SpectrumPriv {
-    Sequence freq;
+    /** frequency axis, uniform one is held implicitly */
+    Axis freq;
     Characteristics values;
+    Size hermitian;
 };
 
-Spectrum::Spectrum(const Sequence &freq, const Characteristics &values)
-    : priv(new SpectrumPriv{freq, values}) {
-    if ((priv->freq.size() <= 0) ||
-        (priv->freq.size() != priv->values.size())) {
+namespace {
+
+void checkSizes(Size freq_size, Size value_size, Size hermitian) {
+    if ((value_size < 2) || (freq_size != value_size)) {
         throw std::runtime_error("Invalid axes sizes");
     }
+    if ((hermitian < 0) ||
+        ((hermitian > 0) && (hermitian / 2 + 1 != value_size))) {
+        throw std::runtime_error("Invalid Hermitian point count");
+    }
 }
 
-Spectrum::Spectrum(Sequence &&freq, Characteristics &&values)
-    : priv(new SpectrumPriv{freq, values}) {
-    if ((priv->freq.size() < 2) || (priv->freq.size() != priv->values.size())) {
-        throw std::runtime_error("Invalid axes sizes");
-    }
+} // namespace
+
+Spectrum::Spectrum(const Sequence &freq, const Characteristics &values,
+                   Size hermitian) {
+    checkSizes(freq.size(), values.size(), hermitian);
+    priv = new SpectrumPriv{{}, values, hermitian};
+    priv->freq.assign(freq);
+}
+
+Spectrum::Spectrum(Sequence &&freq, Characteristics &&values, Size hermitian) {
+    checkSizes(freq.size(), values.size(), hermitian);
+    priv = new SpectrumPriv{{}, std::move(values), hermitian};
+    priv->freq.assign(std::move(freq));
 }
 
-Spectrum::Spectrum(double f0, double f_step, const Characteristics &values) {
+Spectrum::Spectrum(double f0, double f_step, const Characteristics &values,
+                   Size hermitian) {
     auto n = values.size();
-    if (n < 2) {
-        throw std::runtime_error("Empty spectrum");
-    }
-    auto freq = Sequence::LinSpaced(n, f0, f0 + (n - 1) * f_step);
-    priv = new SpectrumPriv{freq, values};
+    checkSizes(n, n, hermitian);
+    priv = new SpectrumPriv{{}, values, hermitian};
+    priv->freq.assign(UniformGrid{f0, f_step, n});
 }
 
-Spectrum::Spectrum(double f0, double f_step, Characteristics &&values) {
+Spectrum::Spectrum(double f0, double f_step, Characteristics &&values,
+                   Size hermitian) {
     auto n = values.size();
-    if (n < 2) {
-        throw std::runtime_error("Empty spectrum");
-    }
-    auto freq = Sequence::LinSpaced(n, f0, f0 + (n - 1) * f_step);
-    priv = new SpectrumPriv{freq, values};
+    checkSizes(n, n, hermitian);
+    priv = new SpectrumPriv{{}, std::move(values), hermitian};
+    priv->freq.assign(UniformGrid{f0, f_step, n});
 }
 
 Spectrum::Spectrum(const Spectrum &other)
-    : priv(new SpectrumPriv{other.priv->freq, other.priv->values}) {}
+    : priv(new SpectrumPriv{other.priv->freq, other.priv->values,
+                            other.priv->hermitian}) {}
 
 Spectrum::Spectrum(Spectrum &&other) : priv(other.priv) {
     other.priv = nullptr;
@@ -56,6 +70,7 @@ Spectrum::~Spectrum() { SAFE_DELETE(priv); }
 Spectrum &Spectrum::operator=(const Spectrum &other) {
     priv->freq = other.priv->freq;
     priv->values = other.priv->values;
+    priv->hermitian = other.priv->hermitian;
     return *this;
 }
 
@@ -66,11 +81,25 @@ Spectrum &Spectrum::operator=(Spectrum &&other) {
     return *this;
 }
 
-Size Spectrum::Count() const { return priv->freq.size(); }
+Size Spectrum::Count() const { return priv->freq.Count(); }
 
-const Sequence &Spectrum::Frenquencies() const { return priv->freq; }
+const Sequence &Spectrum::Frenquencies() const { return priv->freq.Points(); }
 
 const Characteristics &Spectrum::Values() const { return priv->values; }
 
+Eigen::Ref<Characteristics> Spectrum::MutableValues() { return priv->values; }
+
+std::optional<UniformGrid> Spectrum::Grid() const { return priv->freq.Grid(); }
+
+double Spectrum::FrequencyAt(Index index) const {
+    return priv->freq.At(index);
+}
+
+Index Spectrum::NearestIndex(double freq) const {
+    return priv->freq.Nearest(freq);
+}
+
+Size Spectrum::HermitianCount() const { return priv->hermitian; }
+
 } // namespace signal
 } // namespace soil
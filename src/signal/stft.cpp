@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "soil/signal/fft.hpp"
+#include "soil/signal/stft.hpp"
+#include "soil/util/parallel.hpp"
+#include "axis.hpp"
+#include "scratch.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** frames transformed by one task */
+constexpr Size STFT_GRAIN = 16;
+/** partial sums of Welch's method, each one over a fixed range of frames */
+constexpr Size WELCH_ACCUMULATORS = 64;
+/** grow a scratch buffer to at least `n` values */
+template <typename Buffer> auto *grown(Buffer &buffer, Size n) {
+    if (buffer.size() < n) {
+        buffer.resize(n);
+    }
+    return buffer.data();
+}
+
+/** transformation of windowed frames of a column, in scratch of a task */
+class FrameTransform {
+public:
+    FrameTransform(const double *x, const Sequence &coeffs, Size hop,
+                   const RealFFTPlan &plan)
+        : x(x), coeffs(coeffs), hop(hop), plan(plan),
+          padded(grown(scratch.get(), plan.Length()), plan.Length()) {
+        padded.tail(plan.Length() - coeffs.size()).setZero();
+    }
+
+    /** transform given frame into `SpectrumLength()` points */
+    void operator()(Index frame, std::complex<double> *out) {
+        Size n = coeffs.size();
+        padded.head(n) =
+            Eigen::Map<const Sequence>(x + frame * hop, n).cwiseProduct(
+                coeffs);
+        plan.forward(padded.data(), out);
+    }
+
+private:
+    const double *x;
+    const Sequence &coeffs;
+    Size hop;
+    const RealFFTPlan &plan;
+    Scratch<Sequence> scratch;
+    /** frame followed by zeros up to FFT size, in scratch */
+    Eigen::Map<Sequence> padded;
+};
+
+} // namespace
+
+std::optional<Spectrum> Spectrogram::SpectrumAt(Index frame) const {
+    if ((frame < 0) || (frame >= values.cols())) {
+        return std::nullopt;
+    }
+    return Spectrum(frequencies.start, frequencies.step,
+                    Characteristics(values.col(frame)), fft_size);
+}
+
+std::vector<Spectrum> Spectrogram::Spectra() const {
+    std::vector<Spectrum> spectra;
+    spectra.reserve(values.cols());
+    for (Index i = 0; i < values.cols(); ++i) {
+        spectra.push_back(SpectrumAt(i).value());
+    }
+    return spectra;
+}
+
+STFT::STFT(const std::shared_ptr<const Window> &window, Size frame,
+           Size hop, Size fft_size)
+    : window(window), frame(frame), hop(hop),
+      fft_size((fft_size == 0) ? frame : fft_size) {
+    if ((frame < 2) || (hop < 1) || (this->fft_size < frame)) {
+        throw std::runtime_error("Invalid STFT settings");
+    }
+}
+
+Size STFT::Frame() const { return frame; }
+
+Size STFT::Hop() const { return hop; }
+
+Size STFT::FFTSize() const { return fft_size; }
+
+std::optional<Spectrogram> STFT::analyze(const Wavement &w,
+                                         const std::string &key) const {
+    Index column = w.KeyIndex(key);
+    auto dt = uniformStep(w);
+    Size n = w.PointCount();
+    if ((column < 0) || !dt.has_value() || (n < frame)) {
+        return std::nullopt;
+    }
+    Size frames = (n - frame) / hop + 1;
+    auto plan = FFTPlanCache::getReal(fft_size);
+    Size bins = plan->SpectrumLength();
+    Sequence coeffs =
+        window ? window->Coefficients(frame) : Sequence::Ones(frame);
+    Spectrogram result{UniformGrid{w.RefereeAt(0), dt.value() * hop, frames},
+                       UniformGrid{0.0, 1.0 / (dt.value() * fft_size), bins},
+                       fft_size, Eigen::MatrixXcd(bins, frames)};
+    const double *x = w.ValuesRef(column).data();
+    util::parallelFor(frames, STFT_GRAIN, [&](Size begin, Size end) {
+        FrameTransform transform(x, coeffs, hop, *plan);
+        for (Index i = begin; i < end; ++i) {
+            transform(i, result.values.col(i).data());
+        }
+    });
+    return result;
+}
+
+std::optional<PowerSpectralDensity>
+STFT::welch(const Wavement &w, const std::string &key) const {
+    Index column = w.KeyIndex(key);
+    auto dt = uniformStep(w);
+    Size n = w.PointCount();
+    if ((column < 0) || !dt.has_value() || (n < frame)) {
+        return std::nullopt;
+    }
+    Size frames = (n - frame) / hop + 1;
+    auto plan = FFTPlanCache::getReal(fft_size);
+    Size bins = plan->SpectrumLength();
+    Sequence coeffs =
+        window ? window->Coefficients(frame) : Sequence::Ones(frame);
+    // partial sums of fixed ranges of frames, added in order afterwards, so
+    // that memory is bounded and results don't depend on the thread count
+    Size sums = std::min(WELCH_ACCUMULATORS, frames);
+    Eigen::MatrixXd partial = Eigen::MatrixXd::Zero(bins, sums);
+    const double *x = w.ValuesRef(column).data();
+    util::parallelFor(sums, 1, [&](Size begin, Size end) {
+        FrameTransform transform(x, coeffs, hop, *plan);
+        Scratch<Characteristics> scratch;
+        Eigen::Map<Characteristics> spec(grown(scratch.get(), bins), bins);
+        for (Index b = begin; b < end; ++b) {
+            Index last = frames * (b + 1) / sums;
+            for (Index i = frames * b / sums; i < last; ++i) {
+                transform(i, spec.data());
+                partial.col(b) += spec.cwiseAbs2();
+            }
+        }
+    });
+    double fs = 1.0 / dt.value();
+    PowerSpectralDensity psd{UniformGrid{0.0, fs / double(fft_size), bins},
+                             partial.rowwise().sum() /
+                                 (double(frames) * fs * coeffs.squaredNorm())};
+    // negative frequencies are folded, except zero and Nyquist ones
+    Size folded = (fft_size % 2 == 0) ? bins - 2 : bins - 1;
+    psd.values.segment(1, folded) *= 2.0;
+    return psd;
+}
+
+} // namespace signal
+} // namespace soil
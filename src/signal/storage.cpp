@@ -0,0 +1,457 @@
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "soil/signal/storage.hpp"
+#include "../util/mapped_file.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'O', 'I', 'L', 'D', 'A', 'T', 'A'};
+constexpr std::uint32_t ENDIAN_MARK = 0x01020304;
+constexpr std::uint64_t ALIGNMENT = 64;
+
+enum class FileKind : std::uint32_t { Wavement = 1, Spectrum = 2 };
+
+/** tags of stored parameter types */
+enum class ValueTag : std::uint8_t {
+    Double = 1,
+    Int = 2,
+    Bool = 3,
+    Size = 4,
+    String = 5,
+    Complex = 6
+};
+
+/** fixed header at the beginning of file */
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint64_t points;
+    std::uint64_t columns;   /**< stored columns, including referee */
+    std::uint64_t hermitian; /**< only used by spectrum */
+    std::uint64_t directory; /**< offset of directory */
+    std::uint64_t directory_size;
+    std::uint32_t endian;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == ALIGNMENT, "header must fill 64 bytes");
+
+/** sequential binary writer keeping track of offset */
+class Writer {
+public:
+    explicit Writer(const std::string &path)
+        : file(path, std::ios::binary | std::ios::trunc), offset(0) {}
+
+    bool good() const { return bool(file); }
+    std::uint64_t Offset() const { return offset; }
+
+    void bytes(const void *data, std::uint64_t size) {
+        file.write(static_cast<const char *>(data), std::streamsize(size));
+        offset += size;
+    }
+    template <typename T> void value(const T &v) { bytes(&v, sizeof(T)); }
+    void string(const std::string &s) {
+        value(std::uint32_t(s.size()));
+        bytes(s.data(), s.size());
+    }
+    /** pad with zeros to next aligned offset */
+    void align() {
+        static const char zeros[ALIGNMENT] = {};
+        bytes(zeros, (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT);
+    }
+    /** write header at the beginning, leaving file at the end */
+    bool finish(const FileHeader &header) {
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.flush();
+        return bool(file);
+    }
+
+private:
+    std::ofstream file;
+    std::uint64_t offset;
+};
+
+/** bounds-checked reader over a memory region */
+class Reader {
+public:
+    Reader(const char *begin, const char *end) : pos(begin), end(end) {}
+
+    template <typename T> T value() {
+        T v;
+        need(sizeof(T));
+        std::memcpy(&v, pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+    std::string string() {
+        auto size = value<std::uint32_t>();
+        need(size);
+        std::string s(pos, size);
+        pos += size;
+        return s;
+    }
+
+private:
+    const char *pos;
+    const char *end;
+
+    void need(std::uint64_t size) const {
+        if (std::uint64_t(end - pos) < size) {
+            throw std::runtime_error("Truncated directory of soil data file");
+        }
+    }
+};
+
+/** location of a stored column */
+struct ColumnEntry {
+    std::string key;
+    std::uint64_t offset;
+    std::uint64_t doubles;
+};
+
+FileHeader makeHeader(FileKind kind, Size points, Size columns,
+                      Size hermitian) {
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = STORAGE_VERSION;
+    header.kind = std::uint32_t(kind);
+    header.points = std::uint64_t(points);
+    header.columns = std::uint64_t(columns);
+    header.hermitian = std::uint64_t(hermitian);
+    header.endian = ENDIAN_MARK;
+    return header;
+}
+
+/** write a column at next aligned offset and record it */
+void writeColumn(Writer &writer, std::vector<ColumnEntry> &entries,
+                 const std::string &key, const double *data,
+                 std::uint64_t doubles) {
+    writer.align();
+    entries.push_back({key, writer.Offset(), doubles});
+    writer.bytes(data, doubles * sizeof(double));
+}
+
+/** write a viewed column, packing it first if it's strided */
+void writeColumn(Writer &writer, std::vector<ColumnEntry> &entries,
+                 const std::string &key, const SequenceMap &column) {
+    if (column.innerStride() == 1) {
+        writeColumn(writer, entries, key, column.data(), column.size());
+    } else {
+        Sequence packed = column;
+        writeColumn(writer, entries, key, packed.data(), packed.size());
+    }
+}
+
+void writeMetadata(Writer &writer, const util::Parameterized *meta) {
+    if (meta == nullptr) {
+        writer.string("");
+        writer.value(std::uint32_t(0));
+        return;
+    }
+    writer.string(meta->Name());
+    std::vector<std::pair<std::string, std::any>> stored;
+    auto params = meta->Snapshot();
+    for (const auto &name : meta->ParameterNames()) {
+        auto v = params.Parameter(name);
+        if ((v.type() == typeid(double)) || (v.type() == typeid(int)) ||
+            (v.type() == typeid(bool)) || (v.type() == typeid(Size)) ||
+            (v.type() == typeid(std::string)) ||
+            (v.type() == typeid(std::complex<double>))) {
+            stored.push_back({name, v});
+        }
+    }
+    writer.value(std::uint32_t(stored.size()));
+    for (const auto &[name, v] : stored) {
+        writer.string(name);
+        if (v.type() == typeid(double)) {
+            writer.value(ValueTag::Double);
+            writer.value(std::any_cast<double>(v));
+        } else if (v.type() == typeid(int)) {
+            writer.value(ValueTag::Int);
+            writer.value(std::int64_t(std::any_cast<int>(v)));
+        } else if (v.type() == typeid(bool)) {
+            writer.value(ValueTag::Bool);
+            writer.value(std::uint8_t(std::any_cast<bool>(v)));
+        } else if (v.type() == typeid(Size)) {
+            writer.value(ValueTag::Size);
+            writer.value(std::int64_t(std::any_cast<Size>(v)));
+        } else if (v.type() == typeid(std::string)) {
+            writer.value(ValueTag::String);
+            writer.string(std::any_cast<std::string>(v));
+        } else {
+            auto c = std::any_cast<std::complex<double>>(v);
+            writer.value(ValueTag::Complex);
+            writer.value(c.real());
+            writer.value(c.imag());
+        }
+    }
+}
+
+/** write directory and metadata, then the header */
+bool finishFile(Writer &writer, FileHeader header,
+                const std::vector<ColumnEntry> &entries,
+                const util::Parameterized *meta) {
+    writer.align();
+    header.directory = writer.Offset();
+    for (const auto &entry : entries) {
+        writer.string(entry.key);
+        writer.value(entry.offset);
+        writer.value(entry.doubles);
+    }
+    writeMetadata(writer, meta);
+    header.directory_size = writer.Offset() - header.directory;
+    return writer.good() && writer.finish(header);
+}
+
+StoredMetadata readMetadata(Reader &reader) {
+    StoredMetadata meta;
+    meta.name = reader.string();
+    auto count = reader.value<std::uint32_t>();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        auto name = reader.string();
+        switch (reader.value<ValueTag>()) {
+        case ValueTag::Double:
+            meta.parameters[name] = reader.value<double>();
+            break;
+        case ValueTag::Int:
+            meta.parameters[name] = int(reader.value<std::int64_t>());
+            break;
+        case ValueTag::Bool:
+            meta.parameters[name] = (reader.value<std::uint8_t>() != 0);
+            break;
+        case ValueTag::Size:
+            meta.parameters[name] = Size(reader.value<std::int64_t>());
+            break;
+        case ValueTag::String:
+            meta.parameters[name] = reader.string();
+            break;
+        case ValueTag::Complex: {
+            double re = reader.value<double>();
+            double im = reader.value<double>();
+            meta.parameters[name] = std::complex<double>(re, im);
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown parameter type in data file");
+        }
+    }
+    return meta;
+}
+
+/** validated content of a mapped file */
+struct FileContent {
+    FileHeader header;
+    std::vector<ColumnEntry> columns;
+    StoredMetadata meta;
+};
+
+FileContent parseFile(const util::MappedFile &file, FileKind kind) {
+    FileContent content;
+    if (file.Length() < sizeof(FileHeader)) {
+        throw std::runtime_error("Too short to be a soil data file");
+    }
+    auto &header = content.header;
+    std::memcpy(&header, file.Data(), sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a soil data file");
+    }
+    if (header.endian != ENDIAN_MARK) {
+        throw std::runtime_error("Byte order of soil data file not supported");
+    }
+    if ((header.version == 0) || (header.version > STORAGE_VERSION)) {
+        throw std::runtime_error("Version of soil data file not supported");
+    }
+    if (header.kind != std::uint32_t(kind)) {
+        throw std::runtime_error("Unexpected kind of soil data file");
+    }
+    if ((header.directory > file.Length()) ||
+        (header.directory_size > file.Length() - header.directory)) {
+        throw std::runtime_error("Invalid directory of soil data file");
+    }
+    const char *begin = file.Data() + header.directory;
+    Reader reader(begin, begin + header.directory_size);
+    for (std::uint64_t i = 0; i < header.columns; ++i) {
+        ColumnEntry entry;
+        entry.key = reader.string();
+        entry.offset = reader.value<std::uint64_t>();
+        entry.doubles = reader.value<std::uint64_t>();
+        if ((entry.offset % sizeof(double) != 0) ||
+            (entry.offset > file.Length()) ||
+            (entry.doubles > (file.Length() - entry.offset) / sizeof(double))) {
+            throw std::runtime_error("Column out of soil data file");
+        }
+        content.columns.push_back(entry);
+    }
+    content.meta = readMetadata(reader);
+    return content;
+}
+
+} // namespace
+
+Size StoredMetadata::applyTo(util::Parameterized &target) const {
+    Size count = 0;
+    for (const auto &[name, v] : parameters) {
+        if (target.setParameter(name, v)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool saveWavement(const std::string &path, const Wavement &w,
+                  const util::Parameterized *meta) {
+    return saveWavement(path, WavementView(w), meta);
+}
+
+bool saveWavement(const std::string &path, const WavementView &w,
+                  const util::Parameterized *meta) {
+    Writer writer(path);
+    if (!writer.good()) {
+        return false;
+    }
+    Size n = w.PointCount();
+    FileHeader header =
+        makeHeader(FileKind::Wavement, n, w.ValueCount() + 1, 0);
+    writer.value(header);
+    std::vector<ColumnEntry> entries;
+    writeColumn(writer, entries, "", w.Referee());
+    auto keys = w.Keys();
+    for (Index i = 0; i < Index(keys.size()); ++i) {
+        writeColumn(writer, entries, keys[i], w.Values(i));
+    }
+    return finishFile(writer, header, entries, meta);
+}
+
+bool saveSpectrum(const std::string &path, const Spectrum &spec,
+                  const util::Parameterized *meta) {
+    Writer writer(path);
+    if (!writer.good()) {
+        return false;
+    }
+    Size n = spec.Count();
+    FileHeader header =
+        makeHeader(FileKind::Spectrum, n, 2, spec.HermitianCount());
+    writer.value(header);
+    std::vector<ColumnEntry> entries;
+    writeColumn(writer, entries, "freq", spec.Frenquencies().data(), n);
+    writeColumn(writer, entries, "values",
+                reinterpret_cast<const double *>(spec.Values().data()),
+                2 * n);
+    return finishFile(writer, header, entries, meta);
+}
+
+struct MappedWavementPriv {
+    util::MappedFile file;
+    StoredMetadata meta;
+    WavementView view;
+
+    MappedWavementPriv(const std::string &path)
+        : file(path), view(nullptr, 0) {
+        auto content = parseFile(file, FileKind::Wavement);
+        Size n = Size(content.header.points);
+        if (content.columns.empty()) {
+            throw std::runtime_error("Referee missing in soil data file");
+        }
+        auto column = [&](const ColumnEntry &entry) {
+            if (entry.doubles != std::uint64_t(n)) {
+                throw std::runtime_error("Column size mismatch in data file");
+            }
+            return reinterpret_cast<const double *>(file.Data() +
+                                                    entry.offset);
+        };
+        view = WavementView(column(content.columns[0]), n);
+        for (Size i = 1; i < Size(content.columns.size()); ++i) {
+            view.addValues(content.columns[i].key, column(content.columns[i]));
+        }
+        meta = std::move(content.meta);
+    }
+};
+
+MappedWavement::MappedWavement(const std::string &path)
+    : priv(new MappedWavementPriv(path)) {}
+
+MappedWavement::~MappedWavement() { SAFE_DELETE(priv); }
+
+const WavementView &MappedWavement::View() const { return priv->view; }
+
+const StoredMetadata &MappedWavement::Metadata() const { return priv->meta; }
+
+Wavement MappedWavement::toWavement() const { return priv->view.toWavement(); }
+
+struct MappedSpectrumPriv {
+    util::MappedFile file;
+    StoredMetadata meta;
+    Size points;
+    Size hermitian;
+    const double *freq;
+    const std::complex<double> *values;
+
+    MappedSpectrumPriv(const std::string &path) : file(path) {
+        auto content = parseFile(file, FileKind::Spectrum);
+        points = Size(content.header.points);
+        hermitian = Size(content.header.hermitian);
+        if ((content.columns.size() != 2) ||
+            (content.columns[0].doubles != std::uint64_t(points)) ||
+            (content.columns[1].doubles != 2 * std::uint64_t(points))) {
+            throw std::runtime_error("Invalid columns of spectrum data file");
+        }
+        freq = reinterpret_cast<const double *>(file.Data() +
+                                                content.columns[0].offset);
+        values = reinterpret_cast<const std::complex<double> *>(
+            file.Data() + content.columns[1].offset);
+        meta = std::move(content.meta);
+    }
+};
+
+MappedSpectrum::MappedSpectrum(const std::string &path)
+    : priv(new MappedSpectrumPriv(path)) {}
+
+MappedSpectrum::~MappedSpectrum() { SAFE_DELETE(priv); }
+
+Size MappedSpectrum::Count() const { return priv->points; }
+
+Size MappedSpectrum::HermitianCount() const { return priv->hermitian; }
+
+Eigen::Map<const Sequence> MappedSpectrum::Frenquencies() const {
+    return Eigen::Map<const Sequence>(priv->freq, priv->points);
+}
+
+Eigen::Map<const Characteristics> MappedSpectrum::Values() const {
+    return Eigen::Map<const Characteristics>(priv->values, priv->points);
+}
+
+const StoredMetadata &MappedSpectrum::Metadata() const { return priv->meta; }
+
+Spectrum MappedSpectrum::toSpectrum() const {
+    return Spectrum(Sequence(Frenquencies()), Characteristics(Values()),
+                    priv->hermitian);
+}
+
+MappedWavement_ptr loadWavement(const std::string &path) {
+    try {
+        return std::make_shared<const MappedWavement>(path);
+    } catch (const std::runtime_error &) {
+        return nullptr;
+    }
+}
+
+MappedSpectrum_ptr loadSpectrum(const std::string &path) {
+    try {
+        return std::make_shared<const MappedSpectrum>(path);
+    } catch (const std::runtime_error &) {
+        return nullptr;
+    }
+}
+
+} // namespace signal
+} // namespace soil
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "axis.hpp"
+#include "tone.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** points between exact evaluations of uniform tone */
+constexpr Size PHASOR_BLOCK = 64;
+
+/** pi / 2 split into 3 parts, first two with 33 significant bits */
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_2 = 6.07710050650619224932e-11;
+constexpr double PIO2_3 = 2.02226624871116645580e-21;
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+/** `x + ROUNDER - ROUNDER` rounds x to nearest integer */
+constexpr double ROUNDER = 6755399441055744.0; // 1.5 * 2^52
+/** product of quadrant and PIO2_1 is exact below this argument */
+constexpr double REDUCTION_LIMIT = 1e6;
+
+inline std::uint64_t bitsOf(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fromBits(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * sine and cosine by Cody-Waite reduction to [-pi/4, pi/4] and the minimax
+ * polynomials of Cephes, quadrant is handled by bit operations without any
+ * branch so that the loop can be vectorized
+ */
+template <bool WithCos>
+void polyTone(ConstSequenceRef referee, double omega, double phase,
+              double *sin_out, double *cos_out) {
+    const double *t = referee.data();
+    for (Index i = 0; i < referee.size(); ++i) {
+        double x = omega * t[i] + phase;
+        double shifted = x * TWO_OVER_PI + ROUNDER;
+        double q = shifted - ROUNDER;
+        // low bits of mantissa of shifted value are the quadrant
+        std::uint64_t k = bitsOf(shifted);
+        double r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+        double z = r * r;
+        double s = r + r * z *
+                           (((((1.58962301576546568060e-10 * z -
+                                2.50507477628578072866e-8) *
+                                   z +
+                               2.75573136213857245213e-6) *
+                                  z -
+                              1.98412698295895385996e-4) *
+                                 z +
+                             8.33333333332211858878e-3) *
+                                z -
+                            1.66666666666666307295e-1);
+        double c = 1.0 - 0.5 * z +
+                   z * z *
+                       (((((-1.13585365213876817300e-11 * z +
+                            2.08757008419747316778e-9) *
+                               z -
+                           2.75573141792967388112e-7) *
+                              z +
+                          2.48015872888517045348e-5) *
+                             z -
+                         1.38888888888730564116e-3) *
+                            z +
+                        4.16666666666665929218e-2);
+        // odd quadrants swap sine and cosine
+        std::uint64_t swap = std::uint64_t(0) - (k & 1);
+        std::uint64_t sb = bitsOf(s), cb = bitsOf(c);
+        sin_out[i] = fromBits(((sb & ~swap) | (cb & swap)) ^ ((k & 2) << 62));
+        if (WithCos) {
+            cos_out[i] = fromBits(((cb & ~swap) | (sb & swap)) ^
+                                  (((k + 1) & 2) << 62));
+        }
+    }
+}
+
+template <bool WithCos>
+void phasorTone(double t0, double dt, Size n, double omega, double phase,
+                double *sin_out, double *cos_out) {
+    Size width = std::min(n, PHASOR_BLOCK);
+    double rot_sin[PHASOR_BLOCK], rot_cos[PHASOR_BLOCK];
+    for (Index j = 0; j < width; ++j) {
+        rot_sin[j] = std::sin(omega * dt * double(j));
+        rot_cos[j] = std::cos(omega * dt * double(j));
+    }
+    for (Index base = 0; base < n; base += PHASOR_BLOCK) {
+        double angle = omega * (t0 + dt * double(base)) + phase;
+        double bs = std::sin(angle), bc = std::cos(angle);
+        Size len = std::min(PHASOR_BLOCK, n - base);
+        double *s = sin_out + base;
+        for (Index j = 0; j < len; ++j) {
+            s[j] = bs * rot_cos[j] + bc * rot_sin[j];
+        }
+        if (WithCos) {
+            double *c = cos_out + base;
+            for (Index j = 0; j < len; ++j) {
+                c[j] = bc * rot_cos[j] - bs * rot_sin[j];
+            }
+        }
+    }
+}
+
+} // namespace
+
+void toneSinCos(ConstSequenceRef referee, double omega, double phase,
+                double *sin_out, double *cos_out) {
+    Size n = referee.size();
+    if (n >= PHASOR_BLOCK) {
+        // points must be within a few ulps of the grid, as generated by
+        // `Sequence::LinSpaced`, tolerance of axis is relative to interval
+        double t0 = referee[0], span = referee[n - 1] - t0;
+        double ulps = 8.0 * std::numeric_limits<double>::epsilon() *
+                      std::max(std::fabs(t0), std::fabs(referee[n - 1]));
+        auto dt = (span > 0.0)
+                      ? uniformStep(referee, ulps * double(n - 1) / span)
+                      : std::nullopt;
+        if (dt.has_value()) {
+            if (cos_out != nullptr) {
+                phasorTone<true>(t0, *dt, n, omega, phase, sin_out, cos_out);
+            } else {
+                phasorTone<false>(t0, *dt, n, omega, phase, sin_out,
+                                  cos_out);
+            }
+            return;
+        }
+    }
+    double bound = (n > 0) ? std::fabs(omega) * referee.cwiseAbs().maxCoeff() +
+                                 std::fabs(phase)
+                           : 0.0;
+    if (!(bound < REDUCTION_LIMIT)) {
+        // large or non-finite arguments need full range reduction
+        for (Index i = 0; i < n; ++i) {
+            double angle = omega * referee[i] + phase;
+            sin_out[i] = std::sin(angle);
+            if (cos_out != nullptr) {
+                cos_out[i] = std::cos(angle);
+            }
+        }
+    } else if (cos_out != nullptr) {
+        polyTone<true>(referee, omega, phase, sin_out, cos_out);
+    } else {
+        polyTone<false>(referee, omega, phase, sin_out, cos_out);
+    }
+}
+
+} // namespace signal
+} // namespace soil
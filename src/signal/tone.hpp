@@ -0,0 +1,30 @@
+#ifndef SOIL_SIGNAL_TONE_HPP
+#define SOIL_SIGNAL_TONE_HPP
+
+#include "soil/signal/wavement.hpp"
+
+namespace soil {
+namespace signal {
+
+/**
+ * @brief Sine and cosine of `omega * t + phase` at every point of referee
+ *
+ * A uniform referee is synthesized by rotating exact phasors: sine and cosine
+ * are evaluated exactly every 64 points, and points in between are products
+ * with a table of 64 rotations, so error doesn't accumulate. Other referees
+ * use a branchless polynomial evaluating both outputs in one pass.
+ *
+ * @param [in] referee referee of tone
+ * @param [in] omega angular frequency
+ * @param [in] phase initial phase
+ * @param [out] sin_out sine values, `referee.size()` doubles
+ * @param [out] cos_out cosine values, `referee.size()` doubles, nullptr if
+ *              not needed
+ */
+void toneSinCos(ConstSequenceRef referee, double omega, double phase,
+                double *sin_out, double *cos_out);
+
+} // namespace signal
+} // namespace soil
+
+#endif // SOIL_SIGNAL_TONE_HPP
@@ -0,0 +1,256 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "soil/signal/touchstone.hpp"
+#include "axis.hpp"
+#include "../util/mapped_file.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** formats of parameter pairs */
+enum class PairFormat { RI, MA, DB };
+
+/** options given by option line */
+struct Options {
+    double unit = 1e9;
+    char parameter = 'S';
+    PairFormat format = PairFormat::MA;
+    double resistance = 50.0;
+};
+
+bool isSpace(char c) {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+/** get end of line starting at `p`, before line feed */
+const char *lineEnd(const char *p, const char *end) {
+    auto found = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    return (found != nullptr) ? found : end;
+}
+
+/** get count of ports from extension `.sNp`, 0 if unknown */
+Size portsOf(const std::string &path) {
+    auto dot = path.find_last_of('.');
+    if ((dot == std::string::npos) || (path.size() < dot + 4)) {
+        return 0;
+    }
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    if ((ext.front() != 's') || (ext.back() != 'p')) {
+        return 0;
+    }
+    Size ports = 0;
+    auto res = std::from_chars(ext.data() + 1, ext.data() + ext.size() - 1,
+                               ports);
+    return ((res.ec == std::errc()) && (res.ptr == ext.data() + ext.size() - 1))
+               ? ports
+               : 0;
+}
+
+/** parse tokens of option line after `#` */
+void parseOptions(const char *p, const char *end, Options &options) {
+    bool resistance = false;
+    while (p < end) {
+        while ((p < end) && isSpace(*p)) {
+            ++p;
+        }
+        const char *begin = p;
+        while ((p < end) && !isSpace(*p) && (*p != '!')) {
+            ++p;
+        }
+        if (p == begin) {
+            break;
+        }
+        std::string token(begin, p);
+        std::transform(token.begin(), token.end(), token.begin(),
+                       [](unsigned char c) { return char(std::toupper(c)); });
+        if (resistance) {
+            auto res = std::from_chars(begin, p, options.resistance);
+            if (res.ec != std::errc()) {
+                throw std::runtime_error("Invalid reference resistance");
+            }
+            resistance = false;
+        } else if (token == "HZ") {
+            options.unit = 1.0;
+        } else if (token == "KHZ") {
+            options.unit = 1e3;
+        } else if (token == "MHZ") {
+            options.unit = 1e6;
+        } else if (token == "GHZ") {
+            options.unit = 1e9;
+        } else if ((token.size() == 1) &&
+                   (std::strchr("SYZHG", token[0]) != nullptr)) {
+            options.parameter = token[0];
+        } else if (token == "RI") {
+            options.format = PairFormat::RI;
+        } else if (token == "MA") {
+            options.format = PairFormat::MA;
+        } else if (token == "DB") {
+            options.format = PairFormat::DB;
+        } else if (token == "R") {
+            resistance = true;
+        } else if (token[0] == '!') {
+            break;
+        } else {
+            throw std::runtime_error("Invalid option " + token);
+        }
+    }
+}
+
+std::complex<double> pairValue(double a, double b, PairFormat format) {
+    switch (format) {
+    case PairFormat::RI:
+        return {a, b};
+    case PairFormat::MA:
+        return std::polar(a, b * M_PI / 180.0);
+    default:
+        return std::polar(std::pow(10.0, a / 20.0), b * M_PI / 180.0);
+    }
+}
+
+/** parse content of a file, throw runtime error if it's malformed */
+TouchstoneData parse(const char *p, const char *end, Size ports) {
+    Options options;
+    bool has_options = false;
+    Size per = ports * ports;
+    std::vector<double> freq;
+    std::vector<std::complex<double>> values;
+    // rough guess of point count, a number takes about 10 characters
+    freq.reserve((end - p) / (10 * (2 * per + 1)) + 1);
+    values.reserve(freq.capacity() * per);
+    // position of next number in record, 0 for frequency
+    Size pos = 0;
+    double first = 0.0;
+    while (p < end) {
+        char c = *p;
+        if (isSpace(c)) {
+            ++p;
+        } else if ((c == '!') || (c == '[')) {
+            p = lineEnd(p, end);
+        } else if (c == '#') {
+            auto next = lineEnd(p, end);
+            // only the first option line is effective
+            if (!has_options) {
+                parseOptions(p + 1, next, options);
+                has_options = true;
+            }
+            p = next;
+        } else {
+            double number;
+            p += (c == '+') ? 1 : 0;
+            auto res = std::from_chars(p, end, number);
+            if ((res.ec != std::errc()) ||
+                ((res.ptr < end) && !isSpace(*res.ptr) && (*res.ptr != '!'))) {
+                throw std::runtime_error("Invalid number");
+            }
+            p = res.ptr;
+            if (pos == 0) {
+                double f = number * options.unit;
+                // noise parameters of a 2-port file follow network data,
+                // starting at a frequency not above the last one
+                if ((ports == 2) && !freq.empty() && !(f > freq.back())) {
+                    break;
+                }
+                freq.push_back(f);
+            } else if (pos % 2 == 1) {
+                first = number;
+            } else {
+                values.push_back(pairValue(first, number, options.format));
+            }
+            pos = (pos + 1) % (2 * per + 1);
+        }
+    }
+    if ((pos != 0) || freq.empty()) {
+        throw std::runtime_error("Incomplete data");
+    }
+    TouchstoneData data{ports, options.parameter, options.resistance,
+                        Eigen::Map<Sequence>(freq.data(), freq.size()),
+                        Eigen::MatrixXcd(freq.size(), per)};
+    for (Size q = 0; q < per; ++q) {
+        // 2-port files are ordered as S11, S21, S12, S22, others by rows
+        Size column = (ports == 2) ? ((q % 2) * 2 + q / 2) : q;
+        for (Index r = 0; r < Index(freq.size()); ++r) {
+            data.parameters(r, column) = values[r * per + q];
+        }
+    }
+    return data;
+}
+
+} // namespace
+
+Characteristics TouchstoneData::Parameter(Size to, Size from) const {
+    if ((to < 1) || (to > ports) || (from < 1) || (from > ports)) {
+        return Characteristics();
+    }
+    return parameters.col((to - 1) * ports + (from - 1));
+}
+
+std::optional<TouchstoneData> readTouchstone(const std::string &path,
+                                             Size ports) {
+    if (ports <= 0) {
+        ports = portsOf(path);
+    }
+    if (ports <= 0) {
+        return std::nullopt;
+    }
+    try {
+        util::MappedFile file(path);
+        return parse(file.Data(), file.Data() + file.Length(), ports);
+    } catch (const std::runtime_error &) {
+        return std::nullopt;
+    }
+}
+
+std::shared_ptr<MeasuredSParameter> loadTouchstone(const std::string &path,
+                                                   Size to, Size from,
+                                                   double f_step) {
+    auto data = readTouchstone(path);
+    if (!data.has_value()) {
+        return nullptr;
+    }
+    Characteristics ch = data->Parameter(to, from);
+    const Sequence &freq = data->frequencies;
+    Size n = freq.size();
+    if ((ch.size() < 2) ||
+        !(freq.tail(n - 1).array() > freq.head(n - 1).array()).all()) {
+        return nullptr;
+    }
+    double f0 = freq[0], span = freq[n - 1] - f0;
+    double average = span / double(n - 1);
+    double step = (f_step > 0.0) ? f_step : average;
+    bool uniform = uniformStep(freq).has_value() &&
+                   (std::fabs(step - average) <= UNIFORM_TOLERANCE * average);
+    if (!uniform) {
+        // resample by linear interpolation, walking measured points once
+        Size count = Size(std::floor(span / step * (1.0 + 1e-12))) + 1;
+        Characteristics resampled(count);
+        Index j = 0;
+        for (Index k = 0; k < count; ++k) {
+            double f = f0 + double(k) * step;
+            while ((j < n - 2) && (freq[j + 1] < f)) {
+                ++j;
+            }
+            double t = std::min(1.0, (f - freq[j]) / (freq[j + 1] - freq[j]));
+            resampled[k] = (1.0 - t) * ch[j] + t * ch[j + 1];
+        }
+        ch.swap(resampled);
+    }
+    try {
+        return std::make_shared<MeasuredSParameter>(f0, step, ch);
+    } catch (const std::runtime_error &) {
+        return nullptr;
+    }
+}
+
+} // namespace signal
+} // namespace soil
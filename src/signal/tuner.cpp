@@ -1,8 +1,16 @@
-#include <stdexcept>
+#define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
 
 #include "soil/signal/tuner.hpp"
 #include "soil/signal/convert.hpp"
+#include "soil/signal/fft.hpp"
 #include "../misc.hpp"
 
 namespace soil {
@@ -10,33 +18,335 @@ namespace signal {
 
 Tuner::Tuner(const std::string &name) : util::Parameterized(name) {}
 
+Characteristics Tuner::response(const Spectrum &spec) const {
+    Spectrum ones(spec);
+    ones.MutableValues().setOnes();
+    return tune(ones).Values();
+}
+
+namespace {
+
+/** count of frequency grids whose response is cached by one tuner */
+const std::size_t RESPONSE_CACHE_SIZE = 8;
+
+/** interpolation modes of measured characteristics */
+enum Interpolation { Nearest, Linear, Cubic };
+
+/** get interpolation mode by name, -1 if name is invalid */
+int interpolationMode(const std::string &name) {
+    if (name == "nearest") {
+        return Nearest;
+    } else if (name == "linear") {
+        return Linear;
+    } else if (name == "cubic") {
+        return Cubic;
+    }
+    return -1;
+}
+
+/**
+ * @brief Cache of responses, keeping the most recently used ones
+ *
+ * The least recently used response is dropped when the cache is full, so
+ * that a response used on every call is never evicted by responses of
+ * other grids.
+ */
+template <typename Key> class ResponseLRU {
+public:
+    using Response_ptr = std::shared_ptr<const Characteristics>;
+
+    /** get cached response and mark it as used, null if it isn't cached */
+    Response_ptr find(const Key &key) {
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        it->second.used = ++tick;
+        return it->second.response;
+    }
+
+    /** cache response, an existing one of the same key is kept */
+    void insert(const Key &key, const Response_ptr &response) {
+        if (find(key)) {
+            return;
+        }
+        if (entries.size() >= RESPONSE_CACHE_SIZE) {
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.used < oldest->second.used) {
+                    oldest = it;
+                }
+            }
+            entries.erase(oldest);
+        }
+        entries.emplace(key, Entry{response, ++tick});
+    }
+
+private:
+    struct Entry {
+        Response_ptr response;
+        std::uint64_t used;
+    };
+
+    std::map<Key, Entry> entries;
+    std::uint64_t tick = 0;
+};
+
+/** key of cached response, a uniform grid and interpolation options */
+struct ResponseKey {
+    double start, step;
+    Size count;
+    int mode;
+    bool polar;
+
+    bool operator<(const ResponseKey &other) const {
+        return std::tie(start, step, count, mode, polar) <
+               std::tie(other.start, other.step, other.count, other.mode,
+                        other.polar);
+    }
+};
+
+} // namespace
+
 struct MeasuredSPriv {
     double begin;
     double step;
     Characteristics ch;
+    /** magnitude and unwrapped phase of characteristics */
+    Sequence magnitude, phase;
+    /** responses on uniform grids */
+    ResponseLRU<ResponseKey> cache;
+    std::mutex mutex;
+
+    MeasuredSPriv(double begin, double step, const Characteristics &ch)
+        : begin(begin), step(step), ch(ch), magnitude(ch.cwiseAbs()),
+          phase(ch.size()) {
+        for (Index i = 0; i < ch.size(); ++i) {
+            phase[i] = std::arg(ch[i]);
+            if (i > 0) {
+                // unwrap, so that phase is continuous between points
+                double turns = (phase[i] - phase[i - 1]) / (2.0 * M_PI);
+                phase[i] -= 2.0 * M_PI * std::round(turns);
+            }
+        }
+    }
+
+    /**
+     * @brief interpolate characteristics at a position of measured points
+     *
+     * @param [in] x position, in steps from the first measured point
+     * @return interpolated value, 1 outside measured range
+     */
+    std::complex<double> sample(double x, int mode, bool polar) const {
+        Index n = ch.size();
+        if (!((x >= -0.5) && (x < double(n) - 0.5))) {
+            return 1.0;
+        }
+        if ((mode == Nearest) || (n < 2)) {
+            return ch[Index(std::floor(x + 0.5))];
+        }
+        x = std::min(std::max(x, 0.0), double(n - 1));
+        Index i0 = std::min(Index(x), n - 2);
+        double t = x - double(i0);
+        Index first;
+        double weights[4];
+        int taps;
+        if (mode == Linear) {
+            first = i0;
+            taps = 2;
+            weights[0] = 1.0 - t;
+            weights[1] = t;
+        } else {
+            // Catmull-Rom spline, end points are repeated
+            double t2 = t * t, t3 = t2 * t;
+            first = i0 - 1;
+            taps = 4;
+            weights[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+            weights[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+            weights[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+            weights[3] = 0.5 * (t3 - t2);
+        }
+        std::complex<double> sum = 0.0;
+        double mag = 0.0, arg = 0.0;
+        for (int k = 0; k < taps; ++k) {
+            Index pos = std::min(std::max(first + k, Index(0)), n - 1);
+            if (polar) {
+                mag += weights[k] * magnitude[pos];
+                arg += weights[k] * phase[pos];
+            } else {
+                sum += weights[k] * ch[pos];
+            }
+        }
+        return polar ? std::polar(mag, arg) : sum;
+    }
+
+    /** compute response on frequency axis of a spectrum */
+    std::shared_ptr<const Characteristics> compute(const Spectrum &spec,
+                                                   int mode,
+                                                   bool polar) const {
+        auto response = std::make_shared<Characteristics>(spec.Count());
+        for (Index i = 0; i < spec.Count(); ++i) {
+            (*response)[i] =
+                sample((spec.FrequencyAt(i) - begin) / step, mode, polar);
+        }
+        return response;
+    }
+
+    /** get response on frequency axis of a spectrum, cached if uniform */
+    std::shared_ptr<const Characteristics> response(const Spectrum &spec,
+                                                    int mode, bool polar) {
+        auto grid = spec.Grid();
+        if (!grid.has_value()) {
+            return compute(spec, mode, polar);
+        }
+        ResponseKey key{grid->start, grid->step, grid->count, mode, polar};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto cached = cache.find(key);
+            if (cached) {
+                return cached;
+            }
+        }
+        auto computed = compute(spec, mode, polar);
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.insert(key, computed);
+        return computed;
+    }
 };
 
 MeasuredSParameter::MeasuredSParameter(double f0, double f_step,
-                                       const Characteristics &ch)
-    : Tuner("measured_sparameter"), priv(new MeasuredSPriv{f0, f_step, ch}) {
+                                       const Characteristics &ch,
+                                       const std::string &interpolation,
+                                       bool polar)
+    : Tuner("measured_sparameter"), priv(new MeasuredSPriv(f0, f_step, ch)),
+      interpolation_id(prepareParameter("interpolation", interpolation)),
+      polar_id(prepareParameter("polar", polar)) {
     if (f_step < 1e-9) {
         throw std::runtime_error("Invalid frequency step");
     }
+    if (interpolationMode(interpolation) < 0) {
+        throw std::runtime_error("Invalid interpolation mode");
+    }
 }
 
 MeasuredSParameter::~MeasuredSParameter() { SAFE_DELETE(priv); }
 
 Spectrum MeasuredSParameter::tune(const Spectrum &spec) const {
-    Sequence freq = spec.Frenquencies();
-    Characteristics values = spec.Values();
-    assert(freq.size() == values.size());
-    for (Index i = 0; i < freq.size(); ++i) {
-        Index pos = Index((freq[i] - priv->begin) / priv->step + 0.5);
-        if ((pos >= 0) && (pos < priv->ch.size())) {
-            values[i] *= priv->ch[pos];
+    auto params = Snapshot();
+    auto response =
+        priv->response(spec, interpolationMode(params.ParameterAs(
+                                 interpolation_id)),
+                       params.ParameterAs(polar_id));
+    Spectrum tuned(spec);
+    tuned.MutableValues().array() *= response->array();
+    return tuned;
+}
+
+Characteristics MeasuredSParameter::response(const Spectrum &spec) const {
+    auto params = Snapshot();
+    return *priv->response(spec,
+                           interpolationMode(params.ParameterAs(
+                               interpolation_id)),
+                           params.ParameterAs(polar_id));
+}
+
+bool MeasuredSParameter::checkParameter(const std::string &name,
+                                        const std::any &current,
+                                        const std::any &next) const {
+    if (name == "interpolation") {
+        return (next.type() == typeid(std::string)) &&
+               (interpolationMode(std::any_cast<std::string>(next)) >= 0);
+    }
+    return Tuner::checkParameter(name, current, next);
+}
+
+/** key of cached combined response, a uniform grid and stage versions */
+struct CascadeKey {
+    double start, step;
+    Size count;
+    std::vector<std::uint64_t> versions;
+
+    bool operator<(const CascadeKey &other) const {
+        return std::tie(start, step, count, versions) <
+               std::tie(other.start, other.step, other.count, other.versions);
+    }
+};
+
+struct TunerCascadePriv {
+    std::vector<Tuner_ptr> tuners;
+    ResponseLRU<CascadeKey> cache;
+    /** guard stages and cache */
+    std::mutex mutex;
+
+    /** fold responses of stages on frequency axis of a spectrum */
+    static std::shared_ptr<const Characteristics>
+    fold(const std::vector<Tuner_ptr> &stages, const Spectrum &spec) {
+        auto combined = std::make_shared<Characteristics>(
+            Characteristics::Ones(spec.Count()));
+        for (const auto &stage : stages) {
+            combined->array() *= stage->response(spec).array();
+        }
+        return combined;
+    }
+
+    std::shared_ptr<const Characteristics> response(const Spectrum &spec) {
+        std::vector<Tuner_ptr> stages;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stages = tuners;
+        }
+        auto grid = spec.Grid();
+        if (!grid.has_value()) {
+            return fold(stages, spec);
         }
+        CascadeKey key{grid->start, grid->step, grid->count, {}};
+        for (const auto &stage : stages) {
+            key.versions.push_back(stage->Snapshot().Version());
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto cached = cache.find(key);
+            if (cached) {
+                return cached;
+            }
+        }
+        auto combined = fold(stages, spec);
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.insert(key, combined);
+        return combined;
+    }
+};
+
+TunerCascade::TunerCascade(const std::vector<Tuner_ptr> &tuners)
+    : Tuner("tuner_cascade"), priv(new TunerCascadePriv) {
+    for (const auto &tuner : tuners) {
+        append(tuner);
     }
-    return Spectrum{std::move(freq), std::move(values)};
+}
+
+TunerCascade::~TunerCascade() { SAFE_DELETE(priv); }
+
+void TunerCascade::append(const Tuner_ptr &tuner) {
+    if (tuner) {
+        std::lock_guard<std::mutex> lock(priv->mutex);
+        priv->tuners.push_back(tuner);
+    }
+}
+
+std::vector<Tuner_ptr> TunerCascade::Tuners() const {
+    std::lock_guard<std::mutex> lock(priv->mutex);
+    return priv->tuners;
+}
+
+Spectrum TunerCascade::tune(const Spectrum &spec) const {
+    auto combined = priv->response(spec);
+    Spectrum tuned(spec);
+    tuned.MutableValues().array() *= combined->array();
+    return tuned;
+}
+
+Characteristics TunerCascade::response(const Spectrum &spec) const {
+    return *priv->response(spec);
 }
 
 TunerChannel::TunerChannel(const Tuner_ptr &tuner)
@@ -45,14 +355,253 @@ TunerChannel::TunerChannel(const Tuner_ptr &tuner)
 void TunerChannel::setTuner(const Tuner_ptr &tuner) { this->tuner = tuner; }
 
 Wavement TunerChannel::via(const Wavement &w) const {
+    return viaView(WavementView(w));
+}
+
+Wavement TunerChannel::viaView(const WavementView &w) const {
     auto spec = wavementToSpectrum(w);
-    if (tuner && spec.has_value()) {
-        auto tuned = spectrumToWavement(tuner->tune(spec.value()));
-        if (tuned.has_value()) {
-            return tuned.value();
+    if (!tuner || !spec.has_value()) {
+        return w.toWavement();
+    }
+    auto tuned = tuner->tune(spec.value());
+    Size hermitian = spec->HermitianCount();
+    if ((hermitian > 0) && (tuned.HermitianCount() == 0) &&
+        (tuned.Count() == spec->Count())) {
+        // tuner rebuilt the half spectrum without its Hermitian count
+        tuned = Spectrum(tuned.Frenquencies(), tuned.Values(), hermitian);
+    }
+    auto back = spectrumToWavement(tuned);
+    if (!back.has_value() || (back->PointCount() != w.PointCount())) {
+        throw std::runtime_error("Tuned spectrum doesn't match wavement");
+    }
+    // keep original time axis
+    Wavement post(Sequence(w.Referee()));
+    post.reserveValues(back->ValueCount());
+    for (const auto &key : back->Keys()) {
+        post.setValues(key, back->Values(key));
+    }
+    return post;
+}
+
+/** filter state of a stream, last `taps - 1` samples of every column */
+struct StreamState {
+    std::unordered_map<std::string, Sequence> real_history;
+    Characteristics complex_history;
+};
+
+/** FIR filters sampled from a tuner */
+struct StreamKernels {
+    /** version of tuner parameters when sampled */
+    std::uint64_t version;
+    /** spectrum of causal real FIR, scaled by 1 / fft_size */
+    Characteristics real;
+    /** spectrum of causal complex FIR, scaled by 1 / fft_size */
+    Characteristics complex;
+};
+
+struct StreamingTunerPriv {
+    Tuner_ptr tuner;
+    double interval;
+    Size block;
+    Size taps;
+    Size fft_size;
+    /** kernels of the last sampled tuner parameters */
+    std::shared_ptr<const StreamKernels> kernels;
+    /** guard kernels */
+    std::mutex mutex;
+    StreamState state;
+
+    StreamingTunerPriv(const Tuner_ptr &tuner, double interval, Size block,
+                       Size taps)
+        : tuner(tuner), interval(interval), block(block), taps(taps),
+          fft_size(1) {}
+
+    /** get kernels of current tuner parameters, sampled again on changes */
+    std::shared_ptr<const StreamKernels> currentKernels() {
+        std::uint64_t version = tuner ? tuner->Snapshot().Version() : 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!kernels || (kernels->version != version)) {
+            kernels = prepareKernels(version);
         }
+        return kernels;
     }
-    return w;
+
+    /** sample tuner and build kernels of both real and complex streams */
+    std::shared_ptr<const StreamKernels>
+    prepareKernels(std::uint64_t version) const {
+        const Size L = taps, N = fft_size;
+        const double df = 1.0 / (double(L) * interval);
+        Sequence h_real = Sequence::Zero(L);
+        Characteristics h_complex = Characteristics::Zero(L);
+        h_real[0] = 1.0;
+        h_complex[0] = 1.0;
+        if (tuner) {
+            Spectrum half(0.0, df, Characteristics::Ones(L / 2 + 1), L);
+            auto w = spectrumToWavement(tuner->tune(half));
+            if (w.has_value() && (w->PointCount() == L)) {
+                h_real = w->ValuesRef("amp");
+            }
+            Spectrum full(-double(L / 2) * df, df, Characteristics::Ones(L));
+            auto wc = spectrumToWavement(tuner->tune(full));
+            if (wc.has_value() && (wc->PointCount() == L)) {
+                h_complex.real() = wc->ValuesRef("real");
+                h_complex.imag() = wc->ValuesRef("imag");
+            }
+        }
+        // impulse response is centered at 0, delay it to be causal
+        Sequence causal_real = Sequence::Zero(N);
+        Characteristics causal_complex = Characteristics::Zero(N);
+        for (Index i = 0; i < L; ++i) {
+            causal_real[(i + L / 2) % L] = h_real[i];
+            causal_complex[(i + L / 2) % L] = h_complex[i];
+        }
+        return std::make_shared<StreamKernels>(
+            StreamKernels{version, rfft(causal_real) / double(N),
+                          fft(causal_complex) / double(N)});
+    }
+
+    /**
+     * @brief Overlap-save filtering of a real column
+     *
+     * @param [in] kernel spectrum of causal real FIR
+     * @param [in,out] history last `taps - 1` samples of the stream
+     * @param [in] in next samples
+     * @param [in] skip count of leading outputs dropped, the same count of
+     *             zeros is appended to input to flush them out
+     * @return filtered samples, same size as input
+     */
+    Sequence filterReal(const Characteristics &kernel, Sequence &history,
+                        ConstSequenceRef in, Size skip) const {
+        const Size n = in.size(), total = n + skip, keep = taps - 1;
+        auto plan = FFTPlanCache::getReal(fft_size);
+        Sequence buf = Sequence::Zero(fft_size), y(fft_size), out(n);
+        Characteristics X(plan->SpectrumLength());
+        for (Index pos = 0; pos < total; pos += block) {
+            Size len = std::min(block, total - pos);
+            buf.head(keep) = history;
+            for (Index i = 0; i < len; ++i) {
+                buf[keep + i] = (pos + i < n) ? in[pos + i] : 0.0;
+            }
+            history = buf.segment(len, keep);
+            plan->forward(buf.data(), X.data());
+            X.array() *= kernel.array();
+            plan->inverse(X.data(), y.data());
+            for (Index i = std::max(Index(0), skip - pos); i < len; ++i) {
+                out[pos + i - skip] = y[keep + i];
+            }
+        }
+        return out;
+    }
+
+    /** Overlap-save filtering of a complex stream, see #filterReal */
+    Characteristics filterComplex(const Characteristics &kernel,
+                                  Characteristics &history,
+                                  const Characteristics &in,
+                                  Size skip) const {
+        const Size n = in.size(), total = n + skip, keep = taps - 1;
+        auto forward = FFTPlanCache::get(fft_size, FFTPlan::Forward);
+        auto inverse = FFTPlanCache::get(fft_size, FFTPlan::Inverse);
+        Characteristics buf = Characteristics::Zero(fft_size), out(n);
+        for (Index pos = 0; pos < total; pos += block) {
+            Size len = std::min(block, total - pos);
+            buf.head(keep) = history;
+            for (Index i = 0; i < len; ++i) {
+                buf[keep + i] = (pos + i < n) ? in[pos + i] : 0.0;
+            }
+            history = buf.segment(len, keep);
+            forward->execute(buf);
+            buf.array() *= kernel.array();
+            inverse->execute(buf);
+            for (Index i = std::max(Index(0), skip - pos); i < len; ++i) {
+                out[pos + i - skip] = buf[keep + i];
+            }
+        }
+        return out;
+    }
+
+    /** filter a block with given state, see #filterReal for `skip` */
+    Wavement filter(StreamState &st, const Wavement &w, Size skip) {
+        auto current = currentKernels();
+        Wavement post(w.Referee());
+        const Size keep = taps - 1;
+        auto keys = w.Keys();
+        post.reserveValues(keys.size() + 1);
+        auto has = [&keys](const std::string &key) {
+            return std::find(keys.begin(), keys.end(), key) != keys.end();
+        };
+        bool complex = has("imag");
+        std::string real_key = has("real") ? "real" : "amp";
+        if (complex) {
+            if (st.complex_history.size() != keep) {
+                st.complex_history = Characteristics::Zero(keep);
+            }
+            // missing real part is zero
+            Characteristics x = Characteristics::Zero(w.PointCount());
+            if (has(real_key)) {
+                x.real() = w.ValuesRef(real_key);
+            }
+            x.imag() = w.ValuesRef("imag");
+            Characteristics y =
+                filterComplex(current->complex, st.complex_history, x, skip);
+            post.setValues("real", y.real());
+            post.setValues("imag", y.imag());
+        }
+        for (const auto &key : keys) {
+            if (complex && ((key == real_key) || (key == "imag"))) {
+                continue;
+            }
+            auto it = st.real_history.find(key);
+            if (it == st.real_history.end()) {
+                it = st.real_history.emplace(key, Sequence::Zero(keep)).first;
+            }
+            post.setValues(key, filterReal(current->real, it->second,
+                                           w.Values(key), skip));
+        }
+        return post;
+    }
+};
+
+StreamingTunerChannel::StreamingTunerChannel(const Tuner_ptr &tuner,
+                                             double interval,
+                                             Size block_size, Size taps)
+    : Channel("streaming_tuner_channel"),
+      priv(new StreamingTunerPriv(tuner, interval, block_size, taps)) {
+    if (!(interval > 0.0) || (block_size < 1) || (taps < 2)) {
+        SAFE_DELETE(priv);
+        throw std::runtime_error("Invalid stream settings");
+    }
+    while (priv->fft_size < block_size + taps - 1) {
+        priv->fft_size <<= 1;
+    }
+    priv->currentKernels();
+}
+
+StreamingTunerChannel::~StreamingTunerChannel() { SAFE_DELETE(priv); }
+
+void StreamingTunerChannel::setTuner(const Tuner_ptr &tuner) {
+    priv->tuner = tuner;
+    {
+        std::lock_guard<std::mutex> lock(priv->mutex);
+        priv->kernels.reset();
+    }
+    reset();
+}
+
+Size StreamingTunerChannel::BlockSize() const { return priv->block; }
+
+Size StreamingTunerChannel::Taps() const { return priv->taps; }
+
+Size StreamingTunerChannel::Latency() const { return priv->taps / 2; }
+
+Wavement StreamingTunerChannel::feed(const Wavement &block) {
+    return priv->filter(priv->state, block, 0);
+}
+
+void StreamingTunerChannel::reset() { priv->state = StreamState(); }
+
+Wavement StreamingTunerChannel::via(const Wavement &w) const {
+    StreamState state;
+    return priv->filter(state, w, Latency());
 }
 
 } // namespace signal
@@ -1,25 +1,76 @@
+#include <algorithm>
 #include <unordered_map>
 
 #include "soil/signal/wavement.hpp"
+#include "axis.hpp"
 #include "../misc.hpp"
 
 namespace soil {
 namespace signal {
 
 struct WavementPriv {
-    Sequence referee;
-    std::unordered_map<std::string, Sequence> values;
+    /** referee, uniform one is held implicitly */
+    Axis referee;
+    /** columns of values, only the first `keys.size()` ones are used */
+    Eigen::MatrixXd values;
+    /** keys of columns, index in this table is index of column */
+    std::vector<std::string> keys;
+
+    void copy(const WavementPriv &other) {
+        referee = other.referee;
+        values = other.values.leftCols(other.keys.size());
+        keys = other.keys;
+    }
+
+    void clearValues() {
+        values.resize(referee.Count(), 0);
+        keys.clear();
+    }
+
+    /** make room for at least `count` columns, keeping existing ones */
+    void reserve(Size columns) {
+        if (columns > values.cols()) {
+            Eigen::MatrixXd grown(referee.Count(), columns);
+            if (keys.size() > 0) {
+                grown.leftCols(keys.size()) = values.leftCols(keys.size());
+            }
+            values.swap(grown);
+        }
+    }
+
+    /** append a column, return it to be filled */
+    auto append(const std::string &key) {
+        Size used = keys.size();
+        if (used >= values.cols()) {
+            reserve(std::max(Size(1), 2 * used));
+        }
+        keys.push_back(key);
+        return values.col(used);
+    }
+
+    bool acceptable(const std::string &key, Size size) const {
+        return (key.size() > 0) && (size == referee.Count()) &&
+               (std::find(keys.begin(), keys.end(), key) == keys.end());
+    }
 };
 
 Wavement::Wavement() : priv(new WavementPriv) {}
 
-Wavement::Wavement(const Sequence &referee)
-    : priv(new WavementPriv{referee, {}}) {}
+Wavement::Wavement(const Sequence &referee) : priv(new WavementPriv) {
+    setReferee(referee);
+}
 
-Wavement::Wavement(Sequence &&referee) : priv(new WavementPriv{referee, {}}) {}
+Wavement::Wavement(Sequence &&referee) : priv(new WavementPriv) {
+    setReferee(std::move(referee));
+}
 
-Wavement::Wavement(const Wavement &other)
-    : priv(new WavementPriv{other.priv->referee, other.priv->values}) {}
+Wavement::Wavement(const UniformGrid &grid) : priv(new WavementPriv) {
+    setReferee(grid);
+}
+
+Wavement::Wavement(const Wavement &other) : priv(new WavementPriv) {
+    priv->copy(*other.priv);
+}
 
 Wavement::Wavement(Wavement &&other) : priv(other.priv) {
     other.priv = nullptr;
@@ -28,8 +79,9 @@ Wavement::Wavement(Wavement &&other) : priv(other.priv) {
 Wavement::~Wavement() { SAFE_DELETE(priv); }
 
 Wavement &Wavement::operator=(const Wavement &other) {
-    priv->referee = other.priv->referee;
-    priv->values = other.priv->values;
+    if (this != &other) {
+        priv->copy(*other.priv);
+    }
     return *this;
 }
 
@@ -41,58 +93,132 @@ Wavement &Wavement::operator=(Wavement &&other) {
 }
 
 void Wavement::setReferee(const Sequence &referee) {
-    priv->referee = referee;
-    priv->values.clear();
+    priv->referee.assign(referee);
+    priv->clearValues();
 }
 
 void Wavement::setReferee(Sequence &&referee) {
-    priv->referee = referee;
-    priv->values.clear();
+    priv->referee.assign(std::move(referee));
+    priv->clearValues();
+}
+
+void Wavement::setReferee(const UniformGrid &grid) {
+    priv->referee.assign(grid);
+    priv->clearValues();
 }
 
+void Wavement::shiftReferee(double delay) { priv->referee.shift(delay); }
+
 void Wavement::setValues(const std::string &key, const Sequence &values) {
-    if ((key.size() > 0) && (priv->values.find(key) == priv->values.end()) &&
-        (priv->referee.size() == values.size())) {
-        priv->values.insert({key, values});
+    if (priv->acceptable(key, values.size())) {
+        priv->append(key) = values;
     }
 }
 
 void Wavement::setValues(const std::string &key, Sequence &&values) {
-    if ((key.size() > 0) && (priv->values.find(key) == priv->values.end()) &&
-        (priv->referee.size() == values.size())) {
-        priv->values.insert({key, values});
+    if (priv->acceptable(key, values.size())) {
+        priv->append(key) = values;
+    }
+}
+
+void Wavement::setValues(const std::vector<std::string> &keys,
+                         Eigen::MatrixXd &&values) {
+    if ((values.rows() != PointCount()) ||
+        (values.cols() != Index(keys.size()))) {
+        return;
+    }
+    for (Index i = 0; i < Index(keys.size()); ++i) {
+        if (!priv->acceptable(keys[i], values.rows()) ||
+            (std::find(keys.begin(), keys.begin() + i, keys[i]) !=
+             keys.begin() + i)) {
+            return;
+        }
+    }
+    if (priv->keys.empty()) {
+        priv->values = std::move(values);
+        priv->keys = keys;
+    } else {
+        priv->reserve(priv->keys.size() + keys.size());
+        for (Index i = 0; i < Index(keys.size()); ++i) {
+            priv->append(keys[i]) = values.col(i);
+        }
     }
 }
 
-Size Wavement::PointCount() const { return priv->referee.size(); }
+void Wavement::reserveValues(Size count) { priv->reserve(count); }
+
+Size Wavement::PointCount() const { return priv->referee.Count(); }
+
+Size Wavement::ValueCount() const { return priv->keys.size(); }
 
-Size Wavement::ValueCount() const { return priv->values.size(); }
+const Sequence &Wavement::Referee() const { return priv->referee.Points(); }
 
-const Sequence &Wavement::Referee() const { return priv->referee; }
+std::optional<UniformGrid> Wavement::Grid() const {
+    return priv->referee.Grid();
+}
+
+double Wavement::RefereeAt(Index index) const {
+    return priv->referee.At(index);
+}
 
-std::vector<std::string> Wavement::Keys() const {
-    std::vector<std::string> keys_;
-    keys_.reserve(priv->values.size());
-    for (auto pair : priv->values) {
-        keys_.push_back(pair.first);
+Index Wavement::NearestIndex(double referee) const {
+    return priv->referee.Nearest(referee);
+}
+
+std::vector<std::string> Wavement::Keys() const { return priv->keys; }
+
+Index Wavement::KeyIndex(const std::string &key) const {
+    auto it = std::find(priv->keys.begin(), priv->keys.end(), key);
+    return (it != priv->keys.end()) ? Index(it - priv->keys.begin()) : -1;
+}
+
+Sequence Wavement::Values(const std::string &key) const {
+    return ValuesRef(KeyIndex(key));
+}
+
+Sequence Wavement::Values(Index column) const { return ValuesRef(column); }
+
+ConstSequenceRef Wavement::ValuesRef(const std::string &key) const {
+    return ValuesRef(KeyIndex(key));
+}
+
+ConstSequenceRef Wavement::ValuesRef(Index column) const {
+    if ((column >= 0) && (column < Index(priv->keys.size()))) {
+        return priv->values.col(column);
     }
-    return keys_;
+    return Eigen::Map<const Sequence>(nullptr, 0);
+}
+
+Eigen::Ref<const Eigen::MatrixXd> Wavement::ValueMatrix() const {
+    return priv->values.leftCols(priv->keys.size());
 }
 
-const Sequence &Wavement::Values(const std::string &key) const {
-    auto it = priv->values.find(key);
-    if (it != priv->values.end()) {
-        return it->second;
+SequenceRef Wavement::MutableReferee() {
+    return priv->referee.MutablePoints();
+}
+
+SequenceRef Wavement::MutableValues(const std::string &key) {
+    return MutableValues(KeyIndex(key));
+}
+
+SequenceRef Wavement::MutableValues(Index column) {
+    if ((column >= 0) && (column < Index(priv->keys.size()))) {
+        return priv->values.col(column);
     }
-    return Sequence();
+    return Eigen::Map<Sequence>(nullptr, 0);
+}
+
+Eigen::Ref<Eigen::MatrixXd> Wavement::MutableValueMatrix() {
+    return priv->values.leftCols(priv->keys.size());
 }
 
 std::optional<Wavement::Point> Wavement::PointAt(Index index) const {
-    if ((index >= 0) && (index < priv->referee.size())) {
-        Point p{priv->referee[index],
+    if ((index >= 0) && (index < PointCount())) {
+        Point p{RefereeAt(index),
                 std::unordered_map<std::string, double>()};
-        for (auto it = priv->values.begin(); it != priv->values.end(); ++it) {
-            p.values[it->first] = it->second[index];
+        auto row = priv->values.row(index);
+        for (Index i = 0; i < Index(priv->keys.size()); ++i) {
+            p.values[priv->keys[i]] = row[i];
         }
         return p;
     }
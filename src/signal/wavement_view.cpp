@@ -0,0 +1,115 @@
+#include <algorithm>
+
+#include "soil/signal/wavement_view.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace signal {
+
+namespace {
+
+/** pointer and stride of a viewed sequence */
+struct Strided {
+    const double *data;
+    Index stride;
+};
+
+} // namespace
+
+struct WavementViewPriv {
+    Size count;
+    Strided referee;
+    std::vector<std::string> keys;
+    std::vector<Strided> columns;
+
+    SequenceMap map(const Strided &seq) const {
+        return SequenceMap(seq.data, count, Eigen::InnerStride<>(seq.stride));
+    }
+};
+
+WavementView::WavementView(const double *referee, Size count, Index stride)
+    : priv(new WavementViewPriv{(count > 0) ? count : 0,
+                                {referee, stride},
+                                {},
+                                {}}) {}
+
+WavementView::WavementView(const Wavement &w)
+    : priv(new WavementViewPriv{w.PointCount(),
+                                {w.Referee().data(), 1},
+                                {},
+                                {}}) {
+    auto keys = w.Keys();
+    for (Index i = 0; i < Index(keys.size()); ++i) {
+        addValues(keys[i], w.ValuesRef(i).data());
+    }
+}
+
+WavementView::WavementView(const WavementView &other)
+    : priv(new WavementViewPriv(*other.priv)) {}
+
+WavementView::WavementView(WavementView &&other) : priv(other.priv) {
+    other.priv = nullptr;
+}
+
+WavementView::~WavementView() { SAFE_DELETE(priv); }
+
+WavementView &WavementView::operator=(const WavementView &other) {
+    *priv = *other.priv;
+    return *this;
+}
+
+WavementView &WavementView::operator=(WavementView &&other) {
+    SAFE_DELETE(priv);
+    priv = other.priv;
+    other.priv = nullptr;
+    return *this;
+}
+
+bool WavementView::addValues(const std::string &key, const double *values,
+                             Index stride) {
+    if ((key.size() > 0) && ((values != nullptr) || (priv->count == 0)) &&
+        (KeyIndex(key) < 0)) {
+        priv->keys.push_back(key);
+        priv->columns.push_back({values, stride});
+        return true;
+    }
+    return false;
+}
+
+Size WavementView::PointCount() const { return priv->count; }
+
+Size WavementView::ValueCount() const { return priv->keys.size(); }
+
+SequenceMap WavementView::Referee() const {
+    return priv->map(priv->referee);
+}
+
+std::vector<std::string> WavementView::Keys() const { return priv->keys; }
+
+Index WavementView::KeyIndex(const std::string &key) const {
+    auto it = std::find(priv->keys.begin(), priv->keys.end(), key);
+    return (it != priv->keys.end()) ? Index(it - priv->keys.begin()) : -1;
+}
+
+SequenceMap WavementView::Values(const std::string &key) const {
+    return Values(KeyIndex(key));
+}
+
+SequenceMap WavementView::Values(Index column) const {
+    if ((column >= 0) && (column < Index(priv->columns.size()))) {
+        return priv->map(priv->columns[column]);
+    }
+    return SequenceMap(nullptr, 0, Eigen::InnerStride<>(1));
+}
+
+Wavement WavementView::toWavement() const {
+    Wavement w{Sequence(Referee())};
+    w.reserveValues(ValueCount());
+    for (Index i = 0; i < Index(priv->keys.size()); ++i) {
+        w.setValues(priv->keys[i], Sequence(Values(i)));
+    }
+    return w;
+}
+
+} // namespace signal
+} // namespace soil
@@ -1,15 +1,121 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 #include "soil/signal/window.hpp"
+#include "../misc.hpp"
 
 namespace soil {
 namespace signal {
 
+namespace {
+
+/** count of tables cached by one window */
+const std::size_t WINDOW_CACHE_SIZE = 8;
+
+/** kinds of cached tables */
+enum TableKind { RefereeGains, PeriodicTable, SymmetricTable };
+
+/** key of cached table, grid or length and version of parameters */
+struct TableKey {
+    int kind;
+    double start, step;
+    Size count;
+    std::uint64_t version;
+
+    bool operator<(const TableKey &other) const {
+        return std::tie(kind, start, step, count, version) <
+               std::tie(other.kind, other.start, other.step, other.count,
+                        other.version);
+    }
+};
+
+} // namespace
+
+struct WindowPriv {
+    std::map<TableKey, std::shared_ptr<const Sequence>> cache;
+    std::mutex mutex;
+
+    std::shared_ptr<const Sequence> find(const TableKey &key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(key);
+        return (it != cache.end()) ? it->second : nullptr;
+    }
+
+    void store(const TableKey &key, const std::shared_ptr<const Sequence> &t) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.size() >= WINDOW_CACHE_SIZE) {
+            cache.clear();
+        }
+        cache.emplace(key, t);
+    }
+};
+
 Window::Window(const std::string &name, double begin, double duration,
                double max_amp)
-    : Processor(name) {
-    prepareParameter("begin", begin);
-    prepareParameter("duration", (duration > 0) ? duration : 1.0);
-    prepareParameter("max_amp", max_amp);
+    : Processor(name), begin_id(prepareParameter("begin", begin)),
+      duration_id(
+          prepareParameter("duration", (duration > 0) ? duration : 1.0)),
+      max_amp_id(prepareParameter("max_amp", max_amp)),
+      priv(new WindowPriv) {}
+
+Window::~Window() { SAFE_DELETE(priv); }
+
+Wavement Window::via(const Wavement &w) const {
+    Wavement post(w);
+    process(post);
+    return post;
+}
+
+void Window::process(Wavement &w) const {
+    auto params = Snapshot();
+    auto grid = w.Grid();
+    std::shared_ptr<const Sequence> gains;
+    TableKey key{RefereeGains, 0.0, 0.0, 0, params.Version()};
+    if (grid.has_value()) {
+        key.start = grid->start;
+        key.step = grid->step;
+        key.count = grid->count;
+        gains = priv->find(key);
+    }
+    if (!gains) {
+        double begin = params.ParameterAs(begin_id),
+               duration = params.ParameterAs(duration_id);
+        Sequence x = (w.Referee().array() - begin) / duration;
+        auto inside = (x.array() >= 0.0) && (x.array() <= 1.0);
+        Sequence values(x.size());
+        shape(inside.select(x, 0.0), params, values);
+        auto table = std::make_shared<Sequence>(
+            inside.select(values * params.ParameterAs(max_amp_id), 0.0));
+        if (grid.has_value()) {
+            priv->store(key, table);
+        }
+        gains = table;
+    }
+    w.MutableValueMatrix().array().colwise() *= gains->array();
+}
+
+Sequence Window::Coefficients(Size length, bool periodic) const {
+    if (length < 1) {
+        return Sequence();
+    }
+    auto params = Snapshot();
+    TableKey key{periodic ? PeriodicTable : SymmetricTable, 0.0, 0.0, length,
+                 params.Version()};
+    auto table = priv->find(key);
+    if (!table) {
+        Size last = periodic ? length : std::max(Size(1), length - 1);
+        Sequence x = Sequence::LinSpaced(length, 0.0, double(length - 1)) /
+                     double(last);
+        auto values = std::make_shared<Sequence>(length);
+        shape(x, params, *values);
+        priv->store(key, values);
+        table = values;
+    }
+    return *table;
 }
 
 bool Window::checkParameter(const std::string &name, const std::any &current,
@@ -21,5 +127,68 @@ bool Window::checkParameter(const std::string &name, const std::any &current,
     return Processor::checkParameter(name, current, next);
 }
 
+CosineSumWindow::CosineSumWindow(const std::string &name,
+                                 const std::vector<double> &coeffs,
+                                 double begin, double duration,
+                                 double max_amp)
+    : Window(name, begin, duration, max_amp), coeffs(coeffs) {}
+
+void CosineSumWindow::shape(ConstSequenceRef x,
+                            const util::ParameterSnapshot &,
+                            SequenceRef values) const {
+    values.setConstant(coeffs.empty() ? 0.0 : coeffs[0]);
+    Eigen::ArrayXd phase = 2.0 * M_PI * x.array();
+    for (std::size_t k = 1; k < coeffs.size(); ++k) {
+        double sign = (k % 2 == 1) ? -1.0 : 1.0;
+        values.array() += sign * coeffs[k] * (double(k) * phase).cos();
+    }
+}
+
+HannWindow::HannWindow(double begin, double duration, double max_amp)
+    : CosineSumWindow("hann_window", {0.5, 0.5}, begin, duration, max_amp) {}
+
+HammingWindow::HammingWindow(double begin, double duration, double max_amp)
+    : CosineSumWindow("hamming_window", {0.54, 0.46}, begin, duration,
+                      max_amp) {}
+
+BlackmanHarrisWindow::BlackmanHarrisWindow(double begin, double duration,
+                                           double max_amp)
+    : CosineSumWindow("blackman_harris_window",
+                      {0.35875, 0.48829, 0.14128, 0.01168}, begin, duration,
+                      max_amp) {}
+
+FlatTopWindow::FlatTopWindow(double begin, double duration, double max_amp)
+    : CosineSumWindow("flat_top_window",
+                      {0.21557895, 0.41663158, 0.277263158, 0.083578947,
+                       0.006947368},
+                      begin, duration, max_amp) {}
+
+KaiserWindow::KaiserWindow(double beta, double begin, double duration,
+                           double max_amp)
+    : Window("kaiser_window", begin, duration, max_amp),
+      beta_id(prepareParameter("beta", (beta >= 0.0) ? beta : 0.0)) {}
+
+bool KaiserWindow::checkParameter(const std::string &name,
+                                  const std::any &current,
+                                  const std::any &next) const {
+    if (name == "beta") {
+        return (next.type() == typeid(double)) &&
+               (std::any_cast<double>(next) >= 0.0);
+    }
+    return Window::checkParameter(name, current, next);
+}
+
+void KaiserWindow::shape(ConstSequenceRef x,
+                         const util::ParameterSnapshot &params,
+                         SequenceRef values) const {
+    double beta = params.ParameterAs(beta_id);
+    double norm = 1.0 / std::cyl_bessel_i(0.0, beta);
+    for (Index i = 0; i < x.size(); ++i) {
+        double r = 2.0 * x[i] - 1.0;
+        double arg = beta * std::sqrt(std::max(0.0, 1.0 - r * r));
+        values[i] = std::cyl_bessel_i(0.0, arg) * norm;
+    }
+}
+
 } // namespace signal
 } // namespace soil
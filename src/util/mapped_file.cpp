@@ -0,0 +1,70 @@
+#include <fstream>
+#include <stdexcept>
+
+#include "mapped_file.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace soil {
+namespace util {
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string &path) : data(nullptr), length(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open file " + path);
+    }
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        ::close(fd);
+        throw std::runtime_error("Unable to map empty file " + path);
+    }
+    void *addr = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ,
+                        MAP_PRIVATE, fd, 0);
+    // mapping stays valid after file descriptor is closed
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Unable to map file " + path);
+    }
+    data = static_cast<const char *>(addr);
+    length = std::size_t(st.st_size);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        ::munmap(const_cast<char *>(data), length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path) : data(nullptr), length(0) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Unable to open file " + path);
+    }
+    auto size = file.tellg();
+    if (size <= 0) {
+        throw std::runtime_error("Unable to map empty file " + path);
+    }
+    buffer.resize(std::size_t(size));
+    file.seekg(0);
+    if (!file.read(buffer.data(), size)) {
+        throw std::runtime_error("Unable to read file " + path);
+    }
+    data = buffer.data();
+    length = buffer.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+} // namespace util
+} // namespace soil
@@ -0,0 +1,47 @@
+#ifndef SOIL_UTIL_MAPPED_FILE_HPP
+#define SOIL_UTIL_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soil {
+namespace util {
+
+/**
+ * @brief Read-only file mapped into memory, internal helper
+ *
+ * On POSIX systems the file is mapped by `mmap`, so pages are only read when
+ * touched. On other systems the whole file is read into a buffer.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Map a file
+     *
+     * @param [in] path file path
+     *
+     * @note Throw runtime error if file can't be opened, is empty or can't be
+     *       mapped
+     */
+    explicit MappedFile(const std::string &path);
+    /** Destructor, unmap file */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *Data() const { return data; } /**< first byte of file */
+    std::size_t Length() const { return length; } /**< size of file */
+
+private:
+    const char *data;
+    std::size_t length;
+    /** buffer of file content if it can't be mapped */
+    std::vector<char> buffer;
+};
+
+} // namespace util
+} // namespace soil
+
+#endif // SOIL_UTIL_MAPPED_FILE_HPP
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "soil/util/parallel.hpp"
+#include "../misc.hpp"
+
+namespace soil {
+namespace util {
+
+struct TaskGroupPriv {
+    /** spawned tasks not finished yet, decreased under `mutex` */
+    std::atomic<std::size_t> pending{0};
+    std::exception_ptr error;
+    std::mutex mutex;
+    /** signalled when `pending` reaches zero */
+    std::condition_variable done;
+};
+
+namespace {
+
+/** rounds a waiter yields without any task to help, before sleeping */
+constexpr std::size_t WAIT_SPINS = 64;
+
+struct Task {
+    std::function<void()> func;
+    TaskGroupPriv *group;
+
+    void execute() {
+        try {
+            func();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(group->mutex);
+            if (!group->error) {
+                group->error = std::current_exception();
+            }
+        }
+        // a waiter may destroy the group as soon as the lock is released
+        std::lock_guard<std::mutex> lock(group->mutex);
+        if (group->pending.fetch_sub(1) == 1) {
+            group->done.notify_all();
+        }
+    }
+};
+
+/** queue of one worker, owner works at back and thieves at front */
+struct WorkQueue {
+    std::deque<Task> tasks;
+    std::mutex mutex;
+};
+
+/** index of worker running on current thread, -1 for other threads */
+thread_local int current_worker = -1;
+
+class ThreadPool {
+public:
+    ~ThreadPool() { resize(1); }
+
+    std::size_t Size() const { return workers.size() + 1; }
+
+    void resize(std::size_t count) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        stopping = false;
+        queues.clear();
+        // one more queue shared by threads out of pool
+        for (std::size_t i = 0; i < count; ++i) {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (std::size_t i = 1; i < count; ++i) {
+            workers.emplace_back([this, i]() { work(int(i)); });
+        }
+    }
+
+    void push(Task &&task) {
+        // threads out of pool share queue 0
+        auto &queue = *queues[std::max(0, current_worker)];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++queued;
+        }
+        wake.notify_one();
+    }
+
+    /** take a task, from own queue first, then steal from others */
+    bool take(Task &task) {
+        int self = std::max(0, current_worker);
+        int count = int(queues.size());
+        for (int k = 0; k < count; ++k) {
+            auto &queue = *queues[(self + k) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (k == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                std::lock_guard<std::mutex> guard(mutex);
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    /** count of tasks in all queues */
+    std::size_t queued = 0;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void work(int index) {
+        current_worker = index;
+        while (true) {
+            Task task;
+            if (take(task)) {
+                task.execute();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || (queued > 0); });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+};
+
+ThreadPool &pool() {
+    static ThreadPool instance;
+    return instance;
+}
+
+/** a parallel loop whose chunks are claimed by tasks and the caller */
+struct Loop {
+    std::size_t count;
+    std::size_t grain;
+    std::size_t chunks;
+    const std::function<void(std::size_t, std::size_t)> *body;
+    /** next chunk to claim */
+    std::atomic<std::size_t> next{0};
+
+    /** claim and run chunks until none is left */
+    void run() {
+        for (std::size_t c = next.fetch_add(1); c < chunks;
+             c = next.fetch_add(1)) {
+            std::size_t begin = c * grain;
+            (*body)(begin, std::min(count, begin + grain));
+        }
+    }
+};
+
+} // namespace
+
+TaskGroup::TaskGroup() : priv(new TaskGroupPriv) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // errors are only reported by explicit wait
+    }
+    SAFE_DELETE(priv);
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    priv->pending.fetch_add(1);
+    Task t{std::move(task), priv};
+    if (pool().Size() <= 1) {
+        t.execute();
+    } else {
+        pool().push(std::move(t));
+    }
+}
+
+void TaskGroup::wait() {
+    std::size_t spins = 0;
+    while (priv->pending.load() > 0) {
+        Task task;
+        if (pool().take(task)) {
+            task.execute();
+            spins = 0;
+        } else if (++spins < WAIT_SPINS) {
+            std::this_thread::yield();
+        } else {
+            // remaining tasks are running on other threads, and any task
+            // they spawn is helped by themselves or by idle workers
+            std::unique_lock<std::mutex> lock(priv->mutex);
+            priv->done.wait(lock, [this]() { return priv->pending == 0; });
+        }
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(priv->mutex);
+        std::swap(error, priv->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void setThreadCount(std::size_t count) {
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    pool().resize(count);
+}
+
+std::size_t ThreadCount() { return pool().Size(); }
+
+void parallelFor(std::size_t count, std::size_t grain,
+                 const std::function<void(std::size_t, std::size_t)> &body) {
+    grain = std::max(std::size_t(1), grain);
+    std::size_t chunks = (count + grain - 1) / grain;
+    if ((chunks <= 1) || (pool().Size() <= 1)) {
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+    Loop loop{count, grain, chunks, &body};
+    TaskGroup group;
+    std::size_t helpers = std::min(chunks, pool().Size()) - 1;
+    for (std::size_t i = 0; i < helpers; ++i) {
+        group.run([&loop]() { loop.run(); });
+    }
+    try {
+        loop.run();
+    } catch (...) {
+        // let helpers finish before loop goes out of scope
+        loop.next.store(chunks);
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+void parallelForBlocks(
+    std::size_t rows, std::size_t cols, std::size_t grain,
+    const std::function<void(std::size_t, std::size_t, std::size_t,
+                             std::size_t)> &body) {
+    if ((rows == 0) || (cols == 0)) {
+        return;
+    }
+    grain = std::max(std::size_t(1), grain);
+    std::size_t row_chunk = std::min(rows, grain);
+    std::size_t col_chunk =
+        std::min(cols, std::max(std::size_t(1), grain / rows));
+    std::size_t row_blocks = (rows + row_chunk - 1) / row_chunk;
+    std::size_t col_blocks = (cols + col_chunk - 1) / col_chunk;
+    parallelFor(row_blocks * col_blocks, 1,
+                [&](std::size_t begin, std::size_t end) {
+                    for (auto b = begin; b < end; ++b) {
+                        std::size_t r = (b % row_blocks) * row_chunk;
+                        std::size_t c = (b / row_blocks) * col_chunk;
+                        body(r, std::min(rows, r + row_chunk), c,
+                             std::min(cols, c + col_chunk));
+                    }
+                });
+}
+
+} // namespace util
+} // namespace soil
@@ -1,3 +1,5 @@
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "soil/util/parameterized.hpp"
@@ -6,50 +8,98 @@
 namespace soil {
 namespace util {
 
+/** published values of parameters, never modified once published */
+struct ParameterValues {
+    std::uint64_t version;
+    /** values of parameters, index is slot of parameter */
+    std::vector<std::any> values;
+};
+
 struct ParameterizedPriv {
     std::string name;
-    std::unordered_map<std::string, std::any> parameters;
+    /** names of parameters, in the order they are prepared */
+    std::vector<std::string> names;
+    /** slots of parameters by name */
+    std::unordered_map<std::string, int> slots;
+
+    /**
+     * values read by new snapshots, accessed atomically, old values are
+     * freed when the last snapshot referring to them is destroyed
+     */
+    std::shared_ptr<const ParameterValues> current;
+    /** serialize settings */
+    std::mutex writer;
+
+    explicit ParameterizedPriv(const std::string &name)
+        : name(name),
+          current(std::make_shared<ParameterValues>(ParameterValues{0, {}})) {}
+
+    int find(const std::string &name) const {
+        auto it = slots.find(name);
+        return (it != slots.end()) ? it->second : -1;
+    }
+
+    /** get current values */
+    std::shared_ptr<const ParameterValues> load() const {
+        return std::atomic_load(&current);
+    }
+    /** replace current values, with writer locked */
+    void publish(std::shared_ptr<const ParameterValues> next) {
+        std::atomic_store(&current, std::move(next));
+    }
 };
 
+ParameterSnapshot::ParameterSnapshot(ParameterizedPriv *owner)
+    : owner(owner), values(owner->load()) {}
+
+ParameterSnapshot::ParameterSnapshot(ParameterSnapshot &&other)
+    : owner(other.owner), values(std::move(other.values)) {}
+
+ParameterSnapshot::~ParameterSnapshot() = default;
+
+std::uint64_t ParameterSnapshot::Version() const { return values->version; }
+
+std::any ParameterSnapshot::Parameter(const std::string &name,
+                                      const std::any &def) const {
+    auto value = Slot(owner->find(name));
+    return (value != nullptr) ? *value : def;
+}
+
+const std::any *ParameterSnapshot::Slot(int slot) const {
+    if ((slot >= 0) && (slot < int(values->values.size()))) {
+        return &values->values[slot];
+    }
+    return nullptr;
+}
+
 Parameterized::Parameterized(const std::string &name)
-    : priv(new ParameterizedPriv{name, {}}) {}
+    : priv(new ParameterizedPriv(name)) {}
 
 Parameterized::~Parameterized() { SAFE_DELETE(priv); }
 
 std::string Parameterized::Name() const { return priv->name; }
 
 std::vector<std::string> Parameterized::ParameterNames() const {
-    std::vector<std::string> keys_;
-    keys_.reserve(priv->parameters.size());
-    for (const auto &pair : priv->parameters) {
-        keys_.push_back(pair.first);
-    }
-    return keys_;
+    return priv->names;
 }
 
 std::any Parameterized::Parameter(const std::string &name,
                                   const std::any &def) const {
-    auto it = priv->parameters.find(name);
-    if (it != priv->parameters.end()) {
-        return it->second;
-    }
-    return def;
+    return Snapshot().Parameter(name, def);
+}
+
+ParameterSnapshot Parameterized::Snapshot() const {
+    return ParameterSnapshot(priv);
 }
 
 bool Parameterized::setParameter(const std::string &name,
                                  const std::any &value) {
-    auto it = priv->parameters.find(name);
-    if ((it != priv->parameters.end()) &&
-        checkParameter(name, it->second, value)) {
-        it->second = value;
-        return true;
-    }
-    return false;
+    return setParameterSlot(priv->find(name), value);
 }
 
 void Parameterized::prepareParameter(const std::string &name,
                                      const std::any &init_value) {
-    priv->parameters.insert({name, init_value});
+    prepareParameterSlot(name, init_value);
 }
 
 bool Parameterized::checkParameter(const std::string &_,
@@ -58,5 +108,36 @@ bool Parameterized::checkParameter(const std::string &_,
     return current.type() == next.type();
 }
 
+bool Parameterized::setParameterSlot(int slot, const std::any &value) {
+    std::lock_guard<std::mutex> lock(priv->writer);
+    auto current = priv->load();
+    if ((slot >= 0) && (slot < int(current->values.size())) &&
+        checkParameter(priv->names[slot], current->values[slot], value)) {
+        auto next = std::make_shared<ParameterValues>(
+            ParameterValues{current->version + 1, current->values});
+        next->values[slot] = value;
+        priv->publish(std::move(next));
+        return true;
+    }
+    return false;
+}
+
+int Parameterized::prepareParameterSlot(const std::string &name,
+                                        const std::any &init_value) {
+    std::lock_guard<std::mutex> lock(priv->writer);
+    if (priv->slots.count(name) > 0) {
+        return -1;
+    }
+    auto current = priv->load();
+    int slot = int(current->values.size());
+    auto next = std::make_shared<ParameterValues>(
+        ParameterValues{current->version, current->values});
+    next->values.push_back(init_value);
+    priv->names.push_back(name);
+    priv->slots[name] = slot;
+    priv->publish(std::move(next));
+    return slot;
+}
+
 } // namespace util
 } // namespace soil
@@ -0,0 +1,208 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <chrono>
+#include <complex>
+#include <iostream>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#include "soil/signal/convert.hpp"
+#include "soil/signal/fft.hpp"
+#include "soil/signal/signal.hpp"
+
+using namespace soil::signal;
+
+Characteristics naive_dft(const Characteristics &x) {
+    Size n = x.size();
+    Characteristics X(n);
+    for (Index k = 0; k < n; ++k) {
+        std::complex<double> sum = 0.0;
+        for (Index i = 0; i < n; ++i) {
+            sum += x[i] * std::polar(1.0, -2.0 * M_PI * double((k * i) % n) /
+                                              double(n));
+        }
+        X[k] = sum;
+    }
+    return X;
+}
+
+void test_fft_sizes() {
+    std::cout << "Compare FFT with naive DFT" << std::endl;
+    for (Size n : {1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 17, 30, 31, 64, 97, 100,
+                   210, 256, 1000, 1021}) {
+        Characteristics x = Characteristics::Random(n);
+        double err = (fft(x) - naive_dft(x)).cwiseAbs().maxCoeff();
+        double back = (ifft(fft(x)) - x).cwiseAbs().maxCoeff();
+        std::cout << "  - N = " << n << ": error " << err << ", round trip "
+                  << back << std::endl;
+        assert(err < 1e-9 * n);
+        assert(back < 1e-12 * n);
+    }
+
+    // empty input has an identity plan
+    assert(fft(Characteristics()).size() == 0);
+    assert(ifft(Characteristics()).size() == 0);
+    auto empty = FFTPlanCache::get(0, FFTPlan::Inverse);
+    assert(empty->Length() == 0);
+    Characteristics none;
+    empty->execute(none);
+    assert(none.size() == 0);
+}
+
+void test_real_fft() {
+    std::cout << "Compare real FFT with complex FFT" << std::endl;
+    for (Size n : {1, 2, 3, 4, 5, 8, 9, 16, 34, 37, 100, 1024, 1026}) {
+        Sequence x = Sequence::Random(n);
+        Characteristics full = fft(x.cast<std::complex<double>>());
+        Characteristics half = rfft(x);
+        assert(half.size() == n / 2 + 1);
+        double err = (half - full.head(n / 2 + 1)).cwiseAbs().maxCoeff();
+        double back = (irfft(half, n) - x).cwiseAbs().maxCoeff();
+        std::cout << "  - N = " << n << ": error " << err << ", round trip "
+                  << back << std::endl;
+        assert(err < 1e-10 * n);
+        assert(back < 1e-12 * n);
+    }
+
+    Characteristics empty = rfft(Sequence());
+    assert(empty.size() == 1 && empty[0] == std::complex<double>(0.0, 0.0));
+    assert(FFTPlanCache::getReal(0)->SpectrumLength() == 1);
+    assert(irfft(empty, 0).size() == 0);
+}
+
+void test_fft_speed() {
+    for (Size n : {1 << 20, 1000000, 1048573}) {
+        Characteristics x = Characteristics::Random(n);
+        auto start = std::chrono::steady_clock::now();
+        Characteristics X = fft(x);
+        auto stop = std::chrono::steady_clock::now();
+        std::cout << "FFT of " << n << " points costs "
+                  << std::chrono::duration<double, std::milli>(stop - start)
+                         .count()
+                  << " ms" << std::endl;
+        assert((ifft(X) - x).cwiseAbs().maxCoeff() < 1e-9);
+    }
+}
+
+void test_plan_cache() {
+    std::cout << "Share FFT plans through cache" << std::endl;
+    FFTPlanCache::clear();
+    auto plan = FFTPlanCache::get(65536, FFTPlan::Forward);
+    assert(plan == FFTPlanCache::get(65536, FFTPlan::Forward));
+    assert(plan != FFTPlanCache::get(65536, FFTPlan::Inverse));
+    assert(plan->Length() == 65536);
+    assert(plan->TransformDirection() == FFTPlan::Forward);
+    std::cout << "  - " << FFTPlanCache::Count() << " plans cached"
+              << std::endl;
+    assert(FFTPlanCache::Count() == 2);
+
+    // least recently used plans are dropped beyond capacity
+    for (Size n = 2; n < 2 + 2 * FFTPlanCache::CAPACITY; ++n) {
+        FFTPlanCache::get(n, FFTPlan::Forward);
+        FFTPlanCache::get(65536, FFTPlan::Forward);
+    }
+    assert(FFTPlanCache::Count() == FFTPlanCache::CAPACITY);
+    assert(plan == FFTPlanCache::get(65536, FFTPlan::Forward));
+
+    Characteristics x = Characteristics::Random(65536);
+    Characteristics expected = fft(x);
+    std::vector<std::thread> workers;
+    std::vector<double> errors(4, 0.0);
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int r = 0; r < 20; ++r) {
+                Characteristics data = x;
+                FFTPlanCache::get(65536, FFTPlan::Forward)->execute(data);
+                errors[t] = std::max(
+                    errors[t], (data - expected).cwiseAbs().maxCoeff());
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto err : errors) {
+        assert(err == 0.0);
+    }
+
+    Characteristics data = x;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < 100; ++r) {
+        plan->execute(data);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    std::cout << "  - cached 65536-point FFT costs "
+              << std::chrono::duration<double, std::milli>(stop - start)
+                         .count() /
+                     100.0
+              << " ms" << std::endl;
+}
+
+void test_conversion() {
+    std::cout << "Convert complex sine wavement to spectrum" << std::endl;
+    ComplexSineSignal complex_sine(-50.0, 0.3, 2.0);
+    Size n = 1000;
+    double dt = 1e-3;
+    Sequence ts = Sequence::LinSpaced(n, 0.0, double(n - 1) * dt);
+    auto cw = complex_sine.get(ts);
+    auto cspec = wavementToSpectrum(cw);
+    assert(cspec.has_value());
+    assert(cspec->Count() == n && cspec->HermitianCount() == 0);
+    Index cpeak;
+    cspec->Values().cwiseAbs().maxCoeff(&cpeak);
+    std::cout << "  - peak at " << cspec->Frenquencies()[cpeak] << "Hz"
+              << std::endl;
+    assert(fabs(cspec->Frenquencies()[cpeak] + 50.0) < 1e-6);
+    auto cback = spectrumToWavement(cspec.value());
+    assert(cback.has_value());
+    assert((cback->Values("real") - cw.Values("real")).cwiseAbs().maxCoeff() <
+           1e-9);
+    assert((cback->Values("imag") - cw.Values("imag")).cwiseAbs().maxCoeff() <
+           1e-9);
+
+    std::cout << "Convert sine wavement to spectrum" << std::endl;
+    SineSignal sine(50.0, 0.0, 2.0);
+    auto w = sine.get(ts);
+    auto spec = wavementToSpectrum(w);
+    assert(spec.has_value());
+    assert(spec->Count() == n / 2 + 1);
+    assert(spec->HermitianCount() == n);
+    assert(spec->Frenquencies()[0] == 0.0);
+    Index peak;
+    spec->Values().cwiseAbs().maxCoeff(&peak);
+    double freq = fabs(spec->Frenquencies()[peak]);
+    std::cout << "  - peak at " << freq << "Hz with magnitude "
+              << std::abs(spec->Values()[peak]) << std::endl;
+    assert(fabs(freq - 50.0) < 1e-6);
+    assert(fabs(std::abs(spec->Values()[peak]) - n) < 1e-6);
+
+    std::cout << "Convert spectrum back to wavement" << std::endl;
+    auto back = spectrumToWavement(spec.value());
+    assert(back.has_value());
+    assert(back->PointCount() == n);
+    assert(back->Keys() == std::vector<std::string>{"amp"});
+    double err = (back->Values("amp") - w.Values("amp")).cwiseAbs().maxCoeff();
+    double dt_err = fabs(back->Referee()[1] - back->Referee()[0] - dt);
+    std::cout << "  - error " << err << ", interval error " << dt_err
+              << std::endl;
+    assert(err < 1e-9 && dt_err < 1e-12);
+
+    std::cout << "Reject non-uniform referee" << std::endl;
+    Sequence uneven{{0.0}, {0.1}, {0.3}, {0.4}};
+    assert(!wavementToSpectrum(sine.get(uneven)).has_value());
+}
+
+int main() {
+    std::cout << "Test of wavement and spectrum conversion" << std::endl;
+    test_fft_sizes();
+    std::cout << std::endl;
+    test_real_fft();
+    std::cout << std::endl;
+    test_fft_speed();
+    std::cout << std::endl;
+    test_plan_cache();
+    std::cout << std::endl;
+    test_conversion();
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "soil/signal/filter.hpp"
+#include "soil/util/parallel.hpp"
+
+using namespace soil::signal;
+
+/** wavement with given count of pseudo-random columns */
+Wavement make_noise(Size n, Size columns) {
+    Wavement w(Sequence::LinSpaced(n, 0.0, double(n - 1) * 1e-3));
+    for (Index c = 0; c < columns; ++c) {
+        Sequence x(n);
+        for (Index i = 0; i < n; ++i) {
+            x[i] = std::sin(0.37 * double(i * (c + 1)) + 0.11 * double(i % 7));
+        }
+        w.setValues("c" + std::to_string(c), std::move(x));
+    }
+    return w;
+}
+
+/** feed a wavement block by block */
+template <typename Filter>
+Eigen::MatrixXd feed_blocks(Filter &filter, const Wavement &w) {
+    Eigen::MatrixXd out(w.PointCount(), w.ValueCount());
+    auto keys = w.Keys();
+    Size step = 1;
+    for (Index pos = 0; pos < w.PointCount(); pos += step) {
+        step = step * 3 + 1;
+        Size len = std::min(step, w.PointCount() - pos);
+        Wavement part(Sequence(w.Referee().segment(pos, len)));
+        for (Index c = 0; c < Index(keys.size()); ++c) {
+            part.setValues(keys[c], Sequence(w.Values(c).segment(pos, len)));
+        }
+        out.middleRows(pos, len) = filter.feed(part).ValueMatrix();
+    }
+    return out;
+}
+
+void test_fir() {
+    std::cout << "Filter columns by FIR" << std::endl;
+    Sequence taps(5);
+    taps << 0.1, -0.2, 0.5, 0.3, 0.05;
+    FIRFilter fir(taps);
+    assert(fir.Taps() == taps);
+    auto w = make_noise(5000, 3);
+    auto post = fir.via(w);
+    assert(post.Referee() == w.Referee() && post.Keys() == w.Keys());
+    double err = 0.0;
+    for (Index c = 0; c < 3; ++c) {
+        auto x = w.Values(c);
+        for (Index i = 0; i < x.size(); ++i) {
+            double y = 0.0;
+            for (Index k = 0; k < taps.size() && k <= i; ++k) {
+                y += taps[k] * x[i - k];
+            }
+            err = std::max(err, std::abs(y - post.Values(c)[i]));
+        }
+    }
+    std::cout << "  - error against direct convolution " << err << std::endl;
+    assert(err < 1e-12);
+
+    // consecutive blocks and thread count don't change output
+    assert((feed_blocks(fir, w) - post.ValueMatrix()).cwiseAbs().maxCoeff() <
+           1e-12);
+    fir.reset();
+    soil::util::setThreadCount(3);
+    assert(fir.via(w).ValueMatrix() == post.ValueMatrix());
+    soil::util::setThreadCount(1);
+
+    bool thrown = false;
+    try {
+        FIRFilter empty{Sequence()};
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_biquad() {
+    std::cout << "Filter columns by cascade of biquads" << std::endl;
+    Eigen::MatrixXd sos(2, 6);
+    sos << 0.2, 0.4, 0.2, 2.0, -0.5, 0.3, //
+        1.0, -1.0, 0.5, 1.0, 0.2, 0.1;
+    BiquadFilter biquad(sos);
+    assert(biquad.SectionCount() == 2);
+    auto w = make_noise(3000, 6);
+    auto post = biquad.via(w);
+
+    // reference in direct form I, section by section
+    double err = 0.0;
+    for (Index c = 0; c < 6; ++c) {
+        Sequence x = w.Values(c);
+        for (Index s = 0; s < 2; ++s) {
+            auto k = sos.row(s) / sos(s, 3);
+            Sequence y(x.size());
+            for (Index i = 0; i < x.size(); ++i) {
+                y[i] = k[0] * x[i];
+                if (i >= 1) {
+                    y[i] += k[1] * x[i - 1] - k[4] * y[i - 1];
+                }
+                if (i >= 2) {
+                    y[i] += k[2] * x[i - 2] - k[5] * y[i - 2];
+                }
+            }
+            x = y;
+        }
+        err = std::max(err, (x - post.Values(c)).cwiseAbs().maxCoeff());
+    }
+    std::cout << "  - error against direct form I " << err << std::endl;
+    assert(err < 1e-12);
+
+    assert(feed_blocks(biquad, w) == post.ValueMatrix());
+    biquad.reset();
+    Wavement in_place(w);
+    biquad.process(in_place);
+    assert(in_place.ValueMatrix() == post.ValueMatrix());
+
+    bool thrown = false;
+    try {
+        BiquadFilter invalid(Eigen::MatrixXd::Ones(1, 5));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    std::cout << "Test of filters" << std::endl;
+    test_fir();
+    std::cout << std::endl;
+    test_biquad();
+    return 0;
+}
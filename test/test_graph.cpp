@@ -0,0 +1,128 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "soil/signal/graph.hpp"
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/util/parallel.hpp"
+
+using namespace soil::signal;
+using soil::util::setThreadCount;
+using soil::util::TaskGroup;
+
+void test_task_group() {
+    std::cout << "Run nested task groups" << std::endl;
+    setThreadCount(4);
+    std::atomic<int> total(0);
+    TaskGroup group;
+    for (int i = 0; i < 8; ++i) {
+        group.run([&total]() {
+            TaskGroup inner;
+            for (int j = 0; j < 10; ++j) {
+                inner.run([&total]() { ++total; });
+            }
+            inner.wait();
+        });
+    }
+    group.wait();
+    assert(total.load() == 80);
+
+    // waiters sleep while long tasks are running, and wake up when they end
+    for (int round = 0; round < 50; ++round) {
+        TaskGroup slow;
+        std::atomic<int> finished(0);
+        for (int i = 0; i < 3; ++i) {
+            slow.run([&finished, i]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(100 * i));
+                ++finished;
+            });
+        }
+        slow.wait();
+        assert(finished.load() == 3);
+    }
+
+    bool thrown = false;
+    try {
+        group.run([]() { throw std::runtime_error("failed task"); });
+        group.wait();
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    setThreadCount(1);
+}
+
+void test_graph() {
+    std::cout << "Run graph of signals and processors" << std::endl;
+    Sequence ts = Sequence::LinSpaced(50000, 0.0, 1.0);
+    auto sine = std::make_shared<SineSignal>(5.0);
+    auto ramp = std::make_shared<LinearSignal>(2.0, 0.5);
+    auto channel = std::make_shared<LinearChannel>(0.0, 3.0, 1.0);
+    auto ideal = std::make_shared<IdealChannel>();
+
+    // expected results scheduled by hand
+    auto processed = channel->via(sine->get(ts));
+    Sequence sum = processed.Values("value") + ramp->get(ts).Values("value");
+
+    Graph graph;
+    assert(graph.addProcessor(channel, 0) == -1);
+    assert(graph.addSignal(nullptr, ts) == -1);
+    int s = graph.addSignal(sine, ts);
+    int r = graph.addSignal(ramp, ts);
+    int c = graph.addProcessor(channel, s);
+    int i = graph.addProcessor(ideal, c);
+    int a = graph.addNode(
+        [](const std::vector<const Wavement *> &inputs) {
+            Wavement w(inputs[0]->Referee());
+            w.setValues("value", inputs[0]->Values("value") +
+                                     inputs[1]->Values("value"));
+            return w;
+        },
+        {c, r});
+    assert(graph.addNode(nullptr, {s}) == -1);
+    assert(graph.addNode(
+               [](const std::vector<const Wavement *> &) { return Wavement(); },
+               {s, 10}) == -1);
+    assert(graph.NodeCount() == 5);
+
+    for (std::size_t threads : {1, 4}) {
+        setThreadCount(threads);
+        graph.run();
+        assert(graph.Output(c).ValueMatrix() == processed.ValueMatrix());
+        assert(graph.Output(i).ValueMatrix() == processed.ValueMatrix());
+        assert(graph.Output(a).Values("value") == sum);
+        assert(graph.Output(-1).PointCount() == 0);
+    }
+
+    // failure of a node skips its dependents
+    Graph failing;
+    int f = failing.addNode(
+        [](const std::vector<const Wavement *> &) -> Wavement {
+            throw std::runtime_error("failed node");
+        },
+        {});
+    int d = failing.addProcessor(ideal, f);
+    setThreadCount(4);
+    bool thrown = false;
+    try {
+        failing.run();
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(failing.Output(d).PointCount() == 0);
+    setThreadCount(1);
+}
+
+int main() {
+    std::cout << "Test of graph execution" << std::endl;
+    test_task_group();
+    std::cout << std::endl;
+    test_graph();
+    return 0;
+}
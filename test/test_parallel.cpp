@@ -0,0 +1,140 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "soil/signal/composite.hpp"
+#include "soil/signal/filter.hpp"
+#include "soil/signal/processor.hpp"
+#include "soil/signal/resampler.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/util/parallel.hpp"
+
+using namespace soil::signal;
+using soil::util::parallelFor;
+using soil::util::setThreadCount;
+
+void test_parallel_for() {
+    std::cout << "Split loops into fixed chunks" << std::endl;
+    setThreadCount(4);
+    assert(soil::util::ThreadCount() == 4);
+    std::vector<int> hits(100001, 0);
+    std::atomic<int> chunks(0);
+    parallelFor(hits.size(), 1000, [&](std::size_t begin, std::size_t end) {
+        assert((begin % 1000 == 0) && (end - begin <= 1000));
+        for (auto i = begin; i < end; ++i) {
+            ++hits[i];
+        }
+        ++chunks;
+    });
+    assert(chunks.load() == 101);
+    for (auto hit : hits) {
+        assert(hit == 1);
+    }
+
+    // nested loops and exceptions
+    std::atomic<int> total(0);
+    parallelFor(8, 1, [&](std::size_t, std::size_t) {
+        parallelFor(100, 10, [&](std::size_t begin, std::size_t end) {
+            total += int(end - begin);
+        });
+    });
+    assert(total.load() == 800);
+    bool thrown = false;
+    try {
+        parallelFor(10, 1, [](std::size_t begin, std::size_t) {
+            if (begin == 7) {
+                throw std::runtime_error("failed chunk");
+            }
+        });
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // tall matrices are split by rows, wide and short ones by columns
+    std::vector<int> cells(300 * 7, 0);
+    std::atomic<int> blocks(0);
+    soil::util::parallelForBlocks(
+        300, 7, 1000,
+        [&](std::size_t begin, std::size_t end, std::size_t col_begin,
+            std::size_t col_end) {
+            assert((begin == 0) && (end == 300));
+            assert((col_begin % 3 == 0) && (col_end - col_begin <= 3));
+            for (auto c = col_begin; c < col_end; ++c) {
+                for (auto r = begin; r < end; ++r) {
+                    ++cells[c * 300 + r];
+                }
+            }
+            ++blocks;
+        });
+    assert(blocks.load() == 3);
+    for (auto cell : cells) {
+        assert(cell == 1);
+    }
+    blocks = 0;
+    soil::util::parallelForBlocks(
+        2500, 2, 1000,
+        [&](std::size_t begin, std::size_t end, std::size_t col_begin,
+            std::size_t col_end) {
+            assert((begin % 1000 == 0) && (end - begin <= 1000));
+            assert(col_end == col_begin + 1);
+            ++blocks;
+        });
+    assert(blocks.load() == 6);
+    setThreadCount(1);
+}
+
+void test_identical_results() {
+    std::cout << "Produce identical results with any thread count"
+              << std::endl;
+    Sequence ts = Sequence::LinSpaced(100000, 0.0, 2.0);
+    Signal_ptr tone = std::make_shared<ComplexSineSignal>(123.0, 0.2);
+    Signal_ptr ramp = std::make_shared<LinearSignal>(0.5, 0.1);
+    Signal_ptr sine = std::make_shared<SineSignal>(7.0);
+    auto composed = tone * (ramp + sine) + 0.5;
+    LinearChannel channel(0.1, 3.0, -1.0);
+
+    setThreadCount(1);
+    auto serial = channel.via(composed->get(ts));
+    for (std::size_t threads : {2, 3, 8}) {
+        setThreadCount(threads);
+        auto parallel = channel.via(composed->get(ts));
+        assert(parallel.Referee() == serial.Referee());
+        assert(parallel.ValueMatrix() == serial.ValueMatrix());
+    }
+
+    // wide and short wavements are split by columns
+    std::unordered_map<std::string, FunctionalSignal::SIG_FUNC> functions;
+    for (int k = 0; k < 64; ++k) {
+        functions["c" + std::to_string(k)] = [k](double t) {
+            return std::sin(double(k + 1) * t);
+        };
+    }
+    auto wide = std::make_shared<FunctionalSignal>(functions);
+    Sequence short_ts = Sequence::LinSpaced(2000, 0.0, 1.0);
+    LinearChannel delay(2.5e-3, 2.0, 1.0, "grid");
+    FIRFilter fir(Sequence::LinSpaced(31, 1.0, 0.0));
+    RationalResampler resampler(3, 2);
+    setThreadCount(1);
+    auto wide_serial = resampler.via(fir.via(delay.via(wide->get(short_ts))));
+    for (std::size_t threads : {2, 3, 8}) {
+        setThreadCount(threads);
+        auto parallel = resampler.via(fir.via(delay.via(wide->get(short_ts))));
+        assert(parallel.ValueMatrix() == wide_serial.ValueMatrix());
+    }
+    setThreadCount(1);
+}
+
+int main() {
+    std::cout << "Test of parallel execution" << std::endl;
+    test_parallel_for();
+    std::cout << std::endl;
+    test_identical_results();
+    return 0;
+}
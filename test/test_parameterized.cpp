@@ -0,0 +1,99 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+
+using namespace soil::signal;
+
+void test_snapshot() {
+    std::cout << "Pin parameters by snapshot" << std::endl;
+    SineSignal sine(50.0);
+    auto snapshot = sine.Snapshot();
+    auto version = snapshot.Version();
+    // setting while holding a snapshot doesn't wait, the snapshot keeps the
+    // old value
+    assert(sine.setParameter("A", 2.0));
+    assert(std::any_cast<double>(snapshot.Parameter("A")) == 1.0);
+    assert(std::any_cast<double>(sine.Parameter("A")) == 2.0);
+    assert(sine.Snapshot().Version() == version + 1);
+    {
+        auto moved = std::move(snapshot);
+        assert(moved.Version() == version);
+        assert(sine.setParameter("A", 3.0));
+        assert(std::any_cast<double>(moved.Parameter("A")) == 1.0);
+    }
+    std::thread setter([&sine]() { sine.setParameter("A", 2.0); });
+    setter.join();
+    assert(sine.Snapshot().Version() == version + 3);
+    assert(!sine.setParameter("A", 1)); // rejected setting keeps version
+    assert(sine.Snapshot().Version() == version + 3);
+}
+
+/** object with a string parameter prepared from a literal */
+class Moded : public soil::util::Parameterized {
+public:
+    Moded()
+        : Parameterized("moded"), mode_id(prepareParameter("mode", "fast")) {}
+
+    soil::util::ParamId<std::string> mode_id;
+};
+
+void test_literal() {
+    std::cout << "Prepare string parameter from literal" << std::endl;
+    Moded moded;
+    assert(moded.mode_id.Valid());
+    assert(moded.ParameterAs(moded.mode_id) == "fast");
+    assert(moded.setParameter(moded.mode_id, std::string("slow")));
+    assert(moded.ParameterAs("mode", std::string()) == "slow");
+}
+
+void test_concurrent_setting() {
+    std::cout << "Set parameters while processing" << std::endl;
+    LinearChannel channel(0.0, 1.0, 0.0);
+    Wavement w(Sequence::LinSpaced(64, 0.0, 1.0));
+    w.setValues("amp", Sequence::Ones(64));
+    std::atomic<bool> stop(false);
+    std::atomic<int> processed(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 3; ++i) {
+        workers.emplace_back([&]() {
+            while (!stop.load()) {
+                auto post = channel.via(w);
+                // every wavement is processed with a single coeff
+                double k = post.Values("amp")[0];
+                assert(post.Values("amp")[63] == k);
+                assert((k >= 0.0) && (k <= 50.0));
+                processed.fetch_add(1);
+            }
+        });
+    }
+    for (int k = 1; k <= 50; ++k) {
+        channel.setParameter("coeff", double(k));
+        std::this_thread::yield();
+    }
+    while (processed.load() < 100) {
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    std::cout << "  - " << processed.load() << " wavements processed"
+              << std::endl;
+    assert(channel.ParameterAs("coeff", 0.0) == 50.0);
+}
+
+int main() {
+    std::cout << "Test of parameterized objects" << std::endl;
+    test_snapshot();
+    std::cout << std::endl;
+    test_literal();
+    std::cout << std::endl;
+    test_concurrent_setting();
+    return 0;
+}
@@ -0,0 +1,239 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/signal/window.hpp"
+
+using namespace soil::signal;
+
+/** processor without in-place support, doubling referee */
+class Stretcher : public Processor {
+public:
+    Stretcher() : Processor("stretcher") {}
+
+    Wavement via(const Wavement &w) const {
+        Wavement post(Sequence(w.Referee() * 2.0));
+        for (const auto &key : w.Keys()) {
+            post.setValues(key, w.Values(key));
+        }
+        return post;
+    }
+};
+
+void test_in_place() {
+    std::cout << "Process wavement in place" << std::endl;
+    Sequence ts = Sequence::LinSpaced(1000, 0.0, 1.0);
+    auto input = ComplexSineSignal(5.0).get(ts);
+    LinearChannel channel(0.5, 2.0, 1.0);
+
+    auto expected = channel.via(input);
+    Wavement moved(input);
+    auto data = moved.ValuesRef("imag").data();
+    auto output = channel.viaMoved(std::move(moved));
+    assert(output.ValuesRef("imag").data() == data);
+    assert(output.Referee() == expected.Referee());
+    assert(output.ValueMatrix() == expected.ValueMatrix());
+
+    Wavement w(input);
+    channel.process(w);
+    assert(w.ValueMatrix() == expected.ValueMatrix());
+    w.MutableValues("real").setZero();
+    assert(w.Values("real").isZero() && !w.Values("imag").isZero());
+    assert(w.MutableValues("none").size() == 0);
+}
+
+void test_chain() {
+    std::cout << "Chain processors on one buffer" << std::endl;
+    Sequence ts = Sequence::LinSpaced(100, 0.0, 1.0);
+    auto input = SineSignal(3.0).get(ts);
+    auto first = std::make_shared<LinearChannel>(0.1, 2.0, 0.0);
+    auto second = std::make_shared<LinearChannel>(0.2, 1.0, -1.0);
+    ProcessorChain chain({first, nullptr, second});
+    assert(chain.Processors().size() == 2);
+    assert(chain.Name() == "processor_chain");
+
+    auto output = chain.via(input);
+    auto expected = second->via(first->via(input));
+    assert((output.Referee() - expected.Referee()).cwiseAbs().maxCoeff() <
+           1e-12);
+    assert(output.Values("amp") == expected.Values("amp"));
+
+    Wavement w(input);
+    auto data = w.ValuesRef("amp").data();
+    chain.process(w);
+    assert(w.ValuesRef("amp").data() == data);
+
+    // processors without in-place support still work in a chain
+    first->setParameter("coeff", 1.0);
+    chain.append(std::make_shared<Stretcher>());
+    output = chain.via(input);
+    assert(output.Referee()[99] == (1.0 + 0.1 + 0.2) * 2.0);
+    assert(output.Values("amp")[10] == input.Values("amp")[10] - 1.0);
+}
+
+void test_windows() {
+    std::cout << "Apply windows with cached gains" << std::endl;
+    HannWindow hann(0.25, 0.5, 2.0);
+    auto table = hann.Coefficients(8);
+    for (Index i = 0; i < 8; ++i) {
+        assert(std::abs(table[i] - (0.5 - 0.5 * cos(M_PI * i / 4.0))) <
+               1e-15);
+    }
+    auto symmetric = hann.Coefficients(5, false);
+    assert(std::abs(symmetric[1] - 0.5) < 1e-15 && symmetric[2] == 1.0);
+    assert(hann.Coefficients(0).size() == 0);
+
+    Wavement w(Sequence::LinSpaced(101, 0.0, 1.0));
+    w.setValues("a", Sequence::Ones(101));
+    w.setValues("b", Sequence::Constant(101, -1.0));
+    auto post = hann.via(w);
+    assert(post.Values("a")[10] == 0.0 && post.Values("a")[90] == 0.0);
+    assert(std::abs(post.Values("a")[50] - 2.0) < 1e-12);
+    assert(post.Values("b") == -post.Values("a"));
+    assert(hann.via(w).ValueMatrix() == post.ValueMatrix());
+
+    // changing a parameter never reuses cached gains
+    hann.setParameter("begin", 0.5);
+    auto moved = hann.via(w);
+    assert(std::abs(moved.Values("a")[75] - 2.0) < 1e-12);
+    assert(moved.Values("a")[50] == 0.0);
+    Sequence irregular = w.Referee();
+    irregular[1] = 0.011;
+    Wavement explicit_w(irregular);
+    explicit_w.setValues("a", Sequence::Ones(101));
+    assert(hann.via(explicit_w).Values("a")[75] == moved.Values("a")[75]);
+
+    // shapes of other windows, peak is 1
+    Sequence peaks(4);
+    peaks << HammingWindow().Coefficients(9, false)[4],
+        BlackmanHarrisWindow().Coefficients(9, false)[4],
+        FlatTopWindow().Coefficients(9, false)[4],
+        KaiserWindow(5.0).Coefficients(9, false)[4];
+    assert((peaks.array() - 1.0).abs().maxCoeff() < 1e-6);
+    assert(std::abs(HammingWindow().Coefficients(4)[0] - 0.08) < 1e-15);
+    assert(BlackmanHarrisWindow().Coefficients(4)[0] < 1e-4);
+    KaiserWindow kaiser(5.0);
+    assert(!kaiser.setParameter("beta", -1.0));
+    assert(kaiser.setParameter("beta", 0.0));
+    assert(kaiser.Coefficients(16) == Sequence::Ones(16));
+}
+
+void test_delay_modes() {
+    std::cout << "Delay samples on their grid" << std::endl;
+    auto pulse = [](double t) { return exp(-pow((t - 0.5) / 0.05, 2.0)); };
+    Wavement w(UniformGrid{0.0, 1e-3, 1000});
+    Sequence values(1000);
+    for (Index i = 0; i < 1000; ++i) {
+        values[i] = pulse(w.RefereeAt(i));
+    }
+    w.setValues("a", values);
+    w.setValues("b", -values);
+
+    // integer delay is an offset copy
+    LinearChannel grid(3e-3, 1.0, 0.0, "grid");
+    auto post = grid.via(w);
+    assert(post.Grid().has_value() && post.RefereeAt(0) == 0.0);
+    assert(post.Values("a").head(3).isZero());
+    assert(post.Values("a").tail(997) == values.head(997));
+    assert(post.Values("b") == -post.Values("a"));
+
+    // fractional delays, in both directions
+    for (double delay : {12.3e-3, -45.6e-3}) {
+        Sequence expected(1000);
+        for (Index i = 0; i < 1000; ++i) {
+            expected[i] = pulse(w.RefereeAt(i) - delay);
+        }
+        for (const auto &mode : {"grid", "spectral"}) {
+            LinearChannel channel(delay, 2.0, 0.0, mode);
+            auto moved = channel.via(w);
+            assert(moved.Grid().has_value() && moved.RefereeAt(0) == 0.0);
+            double err =
+                (moved.Values("a") - 2.0 * expected).cwiseAbs().maxCoeff();
+            assert(err < 1e-5);
+            assert(moved.Values("b") == -moved.Values("a"));
+        }
+    }
+
+    // cubic interpolation is exact on a cubic, for short delays as well
+    Wavement cubic(UniformGrid{0.0, 1.0, 50});
+    auto poly = [](double t) { return 0.5 + t * (0.1 + t * (t - 10.0)); };
+    Sequence points(50);
+    for (Index i = 0; i < 50; ++i) {
+        points[i] = poly(double(i));
+    }
+    cubic.setValues("a", points);
+    for (double delay : {0.25, -0.25, 0.75, -0.75, 1.5, -1.5, 2.5, -3.5}) {
+        auto moved = LinearChannel(delay, 1.0, 0.0, "grid").via(cubic);
+        Index k = Index(std::floor(delay));
+        // outputs whose 4 inputs are all in wavement, or all outside
+        Index first = std::max(Index(0), k + 2),
+              last = std::min(Index(50), k + 49);
+        for (Index i = first; i < last; ++i) {
+            assert(std::abs(moved.Values("a")[i] - poly(double(i) - delay)) <
+                   1e-9);
+        }
+        if ((k >= 2) || (k <= -3)) {
+            assert(moved.Values("a")[(k > 0) ? 0 : 49] == 0.0);
+        }
+    }
+
+    // explicit referee accumulated by steps is uniform within tolerance
+    Sequence accumulated(1000);
+    accumulated[0] = 0.0;
+    for (Index i = 1; i < 1000; ++i) {
+        accumulated[i] = accumulated[i - 1] + 1e-3;
+    }
+    Wavement stepped(accumulated);
+    assert(!stepped.Grid().has_value());
+    stepped.setValues("a", values);
+    auto moved = LinearChannel(3e-3, 1.0, 0.0, "grid").via(stepped);
+    assert(moved.Referee() == accumulated);
+    assert((moved.Values("a").tail(997) - values.head(997))
+               .cwiseAbs()
+               .maxCoeff() < 1e-9);
+
+    // irregular referee is rejected, and only shifted in referee mode
+    Sequence irregular = Sequence::LinSpaced(10, 0.0, 1.0);
+    irregular[1] = 0.2;
+    Wavement explicit_w(irregular);
+    explicit_w.setValues("a", Sequence::Ones(10));
+    for (const auto &mode : {"grid", "spectral"}) {
+        bool rejected = false;
+        try {
+            LinearChannel(0.5, 1.0, 0.0, mode).via(explicit_w);
+        } catch (const std::runtime_error &) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    auto shifted = LinearChannel(0.5, 1.0, 0.0, "referee").via(explicit_w);
+    assert(shifted.Referee()[1] == 0.7 && shifted.Values("a")[0] == 1.0);
+
+    bool thrown = false;
+    try {
+        LinearChannel(0.0, 1.0, 0.0, "unknown");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(!grid.setParameter("delay_mode", std::string("unknown")));
+    assert(grid.setParameter("delay_mode", std::string("referee")));
+    assert(grid.via(w).RefereeAt(0) == 3e-3);
+}
+
+int main() {
+    std::cout << "Test of processors" << std::endl;
+    test_in_place();
+    std::cout << std::endl;
+    test_chain();
+    std::cout << std::endl;
+    test_windows();
+    std::cout << std::endl;
+    test_delay_modes();
+    return 0;
+}
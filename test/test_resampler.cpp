@@ -0,0 +1,164 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "soil/signal/resampler.hpp"
+#include "soil/util/parallel.hpp"
+
+using namespace soil::signal;
+
+/** wavement with a tone of given frequency, in cycles per sample */
+Wavement make_tone(Size n, double dt, double cycles) {
+    Wavement w(UniformGrid{0.5, dt, n});
+    Sequence x(n);
+    for (Index i = 0; i < n; ++i) {
+        x[i] = std::sin(2.0 * M_PI * cycles * double(i) + 0.3);
+    }
+    w.setValues("amp", std::move(x));
+    return w;
+}
+
+/** maximum error against the tone, far from both ends */
+double tone_error(const Wavement &w, double dt, double cycles, Size margin) {
+    double err = 0.0;
+    for (Index j = margin; j < w.PointCount() - margin; ++j) {
+        double i = (w.RefereeAt(j) - 0.5) / dt;
+        double expected = std::sin(2.0 * M_PI * cycles * i + 0.3);
+        err = std::max(err, std::abs(w.Values("amp")[j] - expected));
+    }
+    return err;
+}
+
+void test_rational() {
+    std::cout << "Resample by rational ratio" << std::endl;
+    double dt = 1e-8;
+    auto w = make_tone(10000, dt, 0.05);
+    RationalResampler up(6, 4, 16);
+    assert(up.Ratio() == 1.5 && up.Taps() == 32);
+    auto post = up.via(w);
+    auto grid = post.Grid();
+    assert(grid.has_value() && grid->count == 14999);
+    assert(grid->start == 0.5 && std::abs(grid->step - dt / 1.5) < 1e-20);
+    double err = tone_error(post, dt, 0.05, 64);
+    std::cout << "  - error of upsampled tone " << err << std::endl;
+    assert(err < 1e-3);
+
+    // tone beyond output Nyquist frequency is suppressed
+    RationalResampler down(1, 4, 16);
+    auto high = down.via(make_tone(10000, dt, 0.4));
+    assert(high.PointCount() == 2500);
+    assert(high.Values("amp").segment(16, 2468).cwiseAbs().maxCoeff() <
+           1e-3);
+    err = tone_error(down.via(make_tone(10000, dt, 0.02)), dt, 0.02, 16);
+    std::cout << "  - error of downsampled tone " << err << std::endl;
+    assert(err < 1e-3);
+
+    soil::util::setThreadCount(3);
+    assert(up.via(w).ValueMatrix() == post.ValueMatrix());
+    soil::util::setThreadCount(1);
+
+    bool thrown = false;
+    try {
+        RationalResampler invalid(0, 2);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_arbitrary() {
+    std::cout << "Resample by arbitrary ratio" << std::endl;
+    double dt = 1e-3;
+    auto w = make_tone(5000, dt, 0.03);
+    ArbitraryResampler resampler(M_SQRT2, 16);
+    assert(std::abs(resampler.Ratio() - M_SQRT2) < 1e-12);
+    auto post = resampler.via(w);
+    assert(post.PointCount() == Size(std::floor(4999 * M_SQRT2)) + 1);
+    double err = tone_error(post, dt, 0.03, 64);
+    std::cout << "  - error of resampled tone " << err << std::endl;
+    assert(err < 1e-3);
+
+    // irregular referee is rejected
+    Sequence ts = Sequence::LinSpaced(100, 0.0, 1.0);
+    ts[50] += 0.001;
+    Wavement irregular(ts);
+    irregular.setValues("amp", Sequence::Ones(100));
+    bool thrown = false;
+    try {
+        resampler.via(irregular);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        ArbitraryResampler invalid(-1.0);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+/** concatenate outputs of blocks of a stream */
+Sequence stream(Resampler &resampler, const Wavement &w) {
+    Sequence out(0);
+    Index begin = 0, size = 7;
+    while (begin < w.PointCount()) {
+        Index n = std::min(size, w.PointCount() - begin);
+        Wavement block(UniformGrid{w.RefereeAt(begin), 1e-8, Size(n)});
+        block.setValues("amp", w.Values("amp").segment(begin, n));
+        auto post = resampler.feed(block);
+        if (out.size() == 0 && post.PointCount() > 0) {
+            assert(post.RefereeAt(0) == w.RefereeAt(0));
+        }
+        out.conservativeResize(out.size() + post.PointCount());
+        out.tail(post.PointCount()) = post.Values("amp");
+        begin += n;
+        size = size * 3 + 1;
+    }
+    return out;
+}
+
+void test_stream() {
+    std::cout << "Resample a stream block by block" << std::endl;
+    auto w = make_tone(20000, 1e-8, 0.05);
+    RationalResampler up(3, 2), down(1, 40, 4);
+    ArbitraryResampler arbitrary(0.37, 16);
+    for (Resampler *resampler : std::initializer_list<Resampler *>{
+             &up, &down, &arbitrary}) {
+        auto whole = resampler->via(w).Values("amp");
+        auto out = stream(*resampler, w);
+        // samples out of the last window are held back
+        Index held = whole.size() - out.size();
+        assert(held >= 0 && held <= Index(resampler->Taps() * 2));
+        double err = (out - whole.head(out.size())).cwiseAbs().maxCoeff();
+        std::cout << "  - error of stream against whole " << err
+                  << std::endl;
+        assert(err < 1e-9);
+
+        // stream restarts after reset
+        resampler->reset();
+        assert(stream(*resampler, w) == out);
+    }
+
+    bool thrown = false;
+    try {
+        up.feed(Wavement(UniformGrid{0.0, 1.0, 1}));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    std::cout << "Test of resamplers" << std::endl;
+    test_rational();
+    std::cout << std::endl;
+    test_arbitrary();
+    std::cout << std::endl;
+    test_stream();
+    return 0;
+}
@@ -1,9 +1,12 @@
 #define _USE_MATH_DEFINES
+#include <cassert>
 #include <iostream>
 #include <math.h>
 
 #include "soil/signal/wavement.hpp"
 #include "soil/signal/signal.hpp"
+#include "soil/signal/composite.hpp"
+#include "soil/util/parallel.hpp"
 
 using namespace soil::signal;
 
@@ -55,17 +58,16 @@ class MyRectWindow : public PulseSignal {
 public:
     explicit MyRectWindow(double begin = 0.0, double duration = 1.0,
                           double amp = 1.0)
-        : PulseSignal("my_rect_window", begin, duration) {
-        prepareParameter("amp", amp);
-    }
+        : PulseSignal("my_rect_window", begin, duration),
+          amp_id(prepareParameter("amp", amp)) {}
 
     std::vector<std::string> Keys() const { return {"amp"}; }
 
     Wavement get(const Eigen::VectorXd &referee) const {
         Wavement w(referee);
         Eigen::VectorXd amps = referee;
-        double amp = ParameterAs("amp", 1.0), begin = ParameterAs("begin", 0.0),
-               end = begin + ParameterAs("duration", 1.0);
+        double amp = ParameterAs(amp_id), begin = ParameterAs(begin_id),
+               end = begin + ParameterAs(duration_id);
         for (auto &value : amps) {
             if ((value >= begin) && (value <= end)) {
                 value = amp;
@@ -76,6 +78,8 @@ public:
         w.setValues("amp", amps);
         return w;
     }
+
+    const soil::util::ParamId<double> amp_id;
 };
 
 void print_parameters(const Signal &signal) {
@@ -111,6 +115,118 @@ void test_wavement(const Signal &signal, const Eigen::VectorXd &ts,
     }
 }
 
+/** compare tones with scalar sin/cos, on uniform and non-uniform referee */
+void test_tone_accuracy() {
+    std::cout << "Test accuracy of sine synthesis" << std::endl;
+    Eigen::VectorXd uniform = Eigen::VectorXd::LinSpaced(10000, -2.0, 3.0);
+    Eigen::VectorXd jittered = uniform;
+    for (Eigen::Index i = 0; i < jittered.size(); i += 3) {
+        jittered[i] += 1e-7 * double(i % 7);
+    }
+    SineSignal sine(123.4, 0.7, 2.0, 0.5);
+    ComplexSineSignal complex(-321.0, -1.1, 1.5);
+    for (const auto &ts : {uniform, jittered}) {
+        auto sw = sine.get(ts);
+        auto amp = sw.Values("amp");
+        auto cw = complex.get(ts);
+        auto real = cw.Values("real"), imag = cw.Values("imag");
+        double err = 0.0;
+        for (Eigen::Index i = 0; i < ts.size(); ++i) {
+            double a = TWO_PI * 123.4 * ts[i] + 0.7;
+            double b = TWO_PI * -321.0 * ts[i] - 1.1;
+            err = std::max(err, fabs(amp[i] - (2.0 * sin(a) + 0.5)));
+            err = std::max(err, fabs(real[i] - 1.5 * cos(b)));
+            err = std::max(err, fabs(imag[i] - 1.5 * sin(b)));
+        }
+        std::cout << "  - maximum error " << err << std::endl;
+        // arguments reach 6000, whose ulp is about 1e-12
+        assert(err < 1e-11);
+    }
+}
+
+void test_composition() {
+    std::cout << "Test composition of signals" << std::endl;
+    Eigen::VectorXd ts = Eigen::VectorXd::LinSpaced(10000, 0.0, 1.0);
+    auto sine = std::make_shared<SineSignal>(5.0);
+    auto ramp = std::make_shared<LinearSignal>(2.0, 0.0);
+    Signal_ptr half = std::make_shared<FixedSignal>(0.5);
+    auto composed = 2.0 * ((Signal_ptr(sine) + ramp) * half) + 1.0;
+    assert((composed->Keys() == std::vector<std::string>{"amp"}));
+    auto outer = std::dynamic_pointer_cast<CompositeSignal>(composed);
+    assert(outer && outer->Name() == "offset");
+    assert(outer->Children().size() == 1);
+
+    auto expected = [&ts](double freq) {
+        Eigen::VectorXd values(ts.size());
+        for (Eigen::Index i = 0; i < ts.size(); ++i) {
+            values[i] =
+                2.0 * ((sin(TWO_PI * freq * ts[i]) + 2.0 * ts[i]) * 0.5) + 1.0;
+        }
+        return values;
+    };
+    auto w = composed->get(ts);
+    double err = (w.Values("amp") - expected(5.0)).cwiseAbs().maxCoeff();
+    std::cout << "  - error of composed signal " << err << std::endl;
+    assert(err < 1e-12);
+
+    // operands stay shared, so their parameters can still be changed
+    sine->setParameter("freq", 7.0);
+    w = composed->get(ts);
+    assert((w.Values("amp") - expected(7.0)).cwiseAbs().maxCoeff() < 1e-12);
+    assert(composed->setParameter("offset", 0.0));
+    w = composed->get(ts);
+    assert(fabs(w.Values("amp")[0]) < 1e-12);
+
+    // single column is applied to every column
+    Signal_ptr tone = std::make_shared<ComplexSineSignal>(3.0);
+    auto modulated = tone * ramp;
+    assert((modulated->Keys() == std::vector<std::string>{"real", "imag"}));
+    auto mw = modulated->get(ts), tw = tone->get(ts);
+    assert(fabs(mw.Values("imag")[9000] -
+                tw.Values("imag")[9000] * 2.0 * ts[9000]) < 1e-12);
+
+    bool thrown = false;
+    try {
+        auto pair = std::make_shared<FunctionalSignal>(
+            std::unordered_map<std::string, FunctionalSignal::SIG_FUNC>{
+                {"x", [](double t) { return t; }},
+                {"y", [](double t) { return t; }}});
+        auto invalid = tone + pair;
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // nested operands, and a function generating another signal inside,
+    // use separate scratch buffers on every thread
+    auto inner = std::make_shared<FunctionalSignal>(
+        std::unordered_map<std::string, FunctionalSignal::BLOCK_FUNC>{
+            {"amp", [ramp](const Sequence &t, Eigen::Ref<Sequence> out) {
+                 out = (Signal_ptr(ramp) + 1.0)->get(t).Values("amp");
+             }}});
+    auto nested = (Signal_ptr(sine) + ramp) * (Signal_ptr(inner) + half);
+    Eigen::VectorXd expected_nested(ts.size());
+    for (Eigen::Index i = 0; i < ts.size(); ++i) {
+        expected_nested[i] = (sin(TWO_PI * 7.0 * ts[i]) + 2.0 * ts[i]) *
+                             (2.0 * ts[i] + 1.5);
+    }
+    for (std::size_t threads : {1, 4}) {
+        soil::util::setThreadCount(threads);
+        auto nw = nested->get(ts);
+        assert((nw.Values("amp") - expected_nested).cwiseAbs().maxCoeff() <
+               1e-12);
+    }
+    soil::util::setThreadCount(1);
+
+    // blocks read parameters from the given snapshots, not from signals
+    auto doubled = 2.0 * Signal_ptr(sine), tripled = 3.0 * Signal_ptr(sine);
+    Eigen::MatrixXd values(ts.size(), 1);
+    doubled->evaluate(ts, values, tripled->SnapshotAll());
+    assert((values.col(0) - 3.0 * sine->get(ts).Values("amp"))
+               .cwiseAbs()
+               .maxCoeff() < 1e-12);
+}
+
 int main() {
     std::cout << "Test of signal process" << std::endl;
 
@@ -164,6 +280,22 @@ int main() {
     test_wavement(func_sig, ts_func, {"linear", "square"});
     std::cout << std::endl;
 
+    std::cout << "Test functional signal with block functions" << std::endl;
+    FunctionalSignal block_sig(
+        {{"linear",
+          [](const Eigen::VectorXd &t, Eigen::Ref<Eigen::VectorXd> out) {
+              out = t.array() + 0.1;
+          }},
+         {"square",
+          [](const Eigen::VectorXd &t, Eigen::Ref<Eigen::VectorXd> out) {
+              out = t.array().square();
+          }}});
+    test_wavement(block_sig, ts_func, {"linear", "square"});
+    auto per_point = func_sig.get(ts_func), per_block = block_sig.get(ts_func);
+    assert(per_point.Values("linear") == per_block.Values("linear"));
+    assert(per_point.Values("square") == per_block.Values("square"));
+    std::cout << std::endl;
+
     std::cout << "Test fixed signal" << std::endl;
     FixedSignal fix_sig(7.0);
     std::cout << "Initial level is " << fix_sig.ParameterAs("level", 1.0)
@@ -199,9 +331,22 @@ int main() {
     std::cout << "Test my rectangle window based on PulseSignal" << std::endl;
     MyRectWindow my_rect_win(0.5, 1.0, 0.7);
     my_rect_win.setParameter("begin", 0.15);
+    assert(my_rect_win.amp_id.Valid());
+    assert(my_rect_win.setParameter(my_rect_win.amp_id, 0.8));
+    assert(my_rect_win.ParameterAs("amp", 0.0) == 0.8);
+    assert(!my_rect_win.setParameter("amp", 1)); // type mismatch
+    assert(my_rect_win.ParameterAs(my_rect_win.amp_id) == 0.8);
+    assert(!my_rect_win.setParameter("duration", -1.0));
+    assert(!my_rect_win.setParameter(soil::util::ParamId<double>(), 1.0));
     print_parameters(my_rect_win);
     test_wavement(my_rect_win, ts_func, {"amp"});
     std::cout << std::endl;
 
+    test_tone_accuracy();
+    std::cout << std::endl;
+
+    test_composition();
+    std::cout << std::endl;
+
     return 0;
 }
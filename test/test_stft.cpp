@@ -0,0 +1,155 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "soil/signal/fft.hpp"
+#include "soil/signal/stft.hpp"
+#include "soil/util/parallel.hpp"
+
+using namespace soil::signal;
+
+/** wavement with a tone of given amplitude and frequency */
+Wavement make_tone(Size n, double dt, double amp, double freq) {
+    Wavement w(UniformGrid{1.0, dt, n});
+    Sequence x(n);
+    for (Index i = 0; i < n; ++i) {
+        x[i] = amp * std::sin(2.0 * M_PI * freq * dt * double(i) + 0.3);
+    }
+    w.setValues("amp", std::move(x));
+    return w;
+}
+
+void test_spectrogram() {
+    std::cout << "Transform frames of a column" << std::endl;
+    double dt = 1e-3;
+    auto w = make_tone(1000, dt, 1.0, 50.0);
+    auto hann = std::make_shared<HannWindow>();
+    STFT stft(hann, 128, 64, 256);
+    assert(stft.Frame() == 128 && stft.Hop() == 64 && stft.FFTSize() == 256);
+
+    auto result = stft.analyze(w, "amp");
+    assert(result.has_value());
+    assert(result->values.cols() == 14 && result->values.rows() == 129);
+    assert(result->times.count == 14 && result->times.start == 1.0);
+    assert(std::abs(result->times.step - 0.064) < 1e-15);
+    assert(result->frequencies.start == 0.0);
+    assert(std::abs(result->frequencies.step - 1000.0 / 256.0) < 1e-12);
+
+    // every frame is the real transformation of windowed points
+    Sequence padded = Sequence::Zero(256);
+    padded.head(128) = w.Values("amp").segment(3 * 64, 128).cwiseProduct(
+        hann->Coefficients(128));
+    Characteristics expected = rfft(padded);
+    assert((result->values.col(3) - expected).cwiseAbs().maxCoeff() < 1e-12);
+
+    auto spectra = result->Spectra();
+    assert(spectra.size() == 14);
+    assert(spectra[3].Values() == result->values.col(3));
+    assert(spectra[3].HermitianCount() == 256);
+    assert(spectra[3].Grid().has_value());
+    assert(spectra[3].NearestIndex(50.0) == 13);
+    assert(!result->SpectrumAt(14).has_value());
+
+    // rectangular frames, without padding
+    auto plain = STFT(nullptr, 100, 100).analyze(w, "amp");
+    assert(plain.has_value() && plain->values.cols() == 10);
+    assert(plain->values.col(9) == rfft(w.Values("amp").tail(100)));
+}
+
+void test_welch() {
+    std::cout << "Estimate power spectral density" << std::endl;
+    double dt = 1e-3;
+    // tone on a bin, power is amp^2 / 2
+    auto w = make_tone(100000, dt, 2.0, 125.0);
+    STFT stft(std::make_shared<HannWindow>(), 256, 128);
+    auto psd = stft.welch(w, "amp");
+    assert(psd.has_value() && psd->values.size() == 129);
+    assert(psd->frequencies.start == 0.0 && psd->frequencies.count == 129);
+    double df = psd->frequencies.step;
+    assert(std::abs(df - 1000.0 / 256.0) < 1e-12);
+    const auto &values = psd->values;
+    Index peak = 0;
+    values.maxCoeff(&peak);
+    assert(peak == 32 && peak * df == 125.0);
+    double power = values.sum() * df;
+    assert(std::abs(power - 2.0) < 2e-2);
+
+    // results don't depend on thread count
+    auto frames = stft.analyze(w, "amp");
+    soil::util::setThreadCount(4);
+    assert(stft.welch(w, "amp")->values == values);
+    assert(stft.analyze(w, "amp")->values == frames->values);
+    soil::util::setThreadCount(1);
+}
+
+void test_parseval() {
+    std::cout << "Keep energy and points of frames" << std::endl;
+    double dt = 1e-3;
+    Wavement w(UniformGrid{0.0, dt, 3000});
+    w.setValues("amp", Sequence::Random(3000));
+    const Sequence &x = w.ValuesRef("amp");
+
+    // every frame transforms back to its windowed points
+    auto hann = std::make_shared<HannWindow>();
+    STFT stft(hann, 100, 30, 128);
+    auto result = stft.analyze(w, "amp");
+    for (Index i = 0; i < result->values.cols(); ++i) {
+        Sequence back = irfft(result->values.col(i), 128);
+        Sequence expected =
+            x.segment(i * 30, 100).cwiseProduct(hann->Coefficients(100));
+        assert((back.head(100) - expected).cwiseAbs().maxCoeff() < 1e-12);
+        assert(back.tail(28).cwiseAbs().maxCoeff() < 1e-12);
+    }
+
+    // rectangular frames covering the column keep its mean power, whether
+    // the Nyquist bin exists or not
+    for (Size fft_size : {100, 101, 128}) {
+        Size frame = (fft_size == 101) ? 101 : 100;
+        auto psd = STFT(nullptr, frame, frame, fft_size).welch(w, "amp");
+        Size covered = (3000 / frame) * frame;
+        double power = x.head(covered).squaredNorm() / double(covered);
+        assert(psd->values.minCoeff() >= 0.0);
+        assert(std::abs(psd->values.sum() * psd->frequencies.step - power) <
+               1e-12);
+    }
+}
+
+void test_invalid() {
+    std::cout << "Reject invalid settings and inputs" << std::endl;
+    for (auto sizes : {std::vector<Size>{1, 1, 0}, {16, 0, 0}, {16, 8, 15}}) {
+        bool thrown = false;
+        try {
+            STFT(nullptr, sizes[0], sizes[1], sizes[2]);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    STFT stft(nullptr, 16, 8);
+    auto w = make_tone(100, 1e-3, 1.0, 10.0);
+    assert(!stft.analyze(w, "unknown").has_value());
+    assert(!stft.welch(make_tone(15, 1e-3, 1.0, 10.0), "amp").has_value());
+    Sequence irregular = w.Referee();
+    irregular[1] += 1e-4;
+    Wavement explicit_w(irregular);
+    explicit_w.setValues("amp", w.Values("amp"));
+    assert(!stft.analyze(explicit_w, "amp").has_value());
+    assert(!stft.welch(explicit_w, "amp").has_value());
+}
+
+int main() {
+    std::cout << "Test of short-time fourier transformation" << std::endl;
+    test_spectrogram();
+    std::cout << std::endl;
+    test_welch();
+    std::cout << std::endl;
+    test_parseval();
+    std::cout << std::endl;
+    test_invalid();
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <cassert>
+#include <complex>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/signal/storage.hpp"
+
+using namespace soil::signal;
+
+std::string temp_path(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void test_wavement_file() {
+    std::cout << "Save and map wavement file" << std::endl;
+    std::string path = temp_path("soil_test_wavement.bin");
+    Size n = 1001;
+    Sequence ts = Sequence::LinSpaced(n, 0.0, 1.0);
+    auto w = ComplexSineSignal(5.0).get(ts);
+    LinearChannel channel(0.5, 2.0, -1.0);
+    assert(saveWavement(path, w, &channel));
+
+    auto mapped = loadWavement(path);
+    assert(mapped);
+    const auto &view = mapped->View();
+    assert(view.PointCount() == n);
+    assert((view.Keys() == w.Keys()));
+    assert(view.Referee() == ts);
+    assert(view.Values("imag") == w.Values("imag"));
+    // columns are aligned in mapped file
+    assert(reinterpret_cast<std::uintptr_t>(view.Values(Index(1)).data()) %
+               64 ==
+           0);
+    assert(mapped->toWavement().Values("real") == w.Values("real"));
+
+    const auto &meta = mapped->Metadata();
+    assert(meta.name == "linear_channel");
+    LinearChannel restored;
+    assert(meta.applyTo(restored) == 4);
+    assert(restored.ParameterAs("coeff", 0.0) == 2.0);
+    assert(restored.ParameterAs("delay_mode", std::string()) == "referee");
+    assert(restored.ParameterAs("offset", 0.0) == -1.0);
+
+    // mapped wavement is not a spectrum file
+    assert(!loadSpectrum(path));
+    std::filesystem::remove(path);
+}
+
+void test_spectrum_file() {
+    std::cout << "Save and map spectrum file" << std::endl;
+    std::string path = temp_path("soil_test_spectrum.bin");
+    Characteristics values(9);
+    for (Index i = 0; i < values.size(); ++i) {
+        values[i] = std::complex<double>(double(i), -0.5 * double(i));
+    }
+    Spectrum spec(0.0, 10.0, values, 16);
+    assert(saveSpectrum(path, spec));
+
+    auto mapped = loadSpectrum(path);
+    assert(mapped);
+    assert(mapped->Count() == 9 && mapped->HermitianCount() == 16);
+    assert(mapped->Frenquencies() == spec.Frenquencies());
+    assert(mapped->Values() == values);
+    assert(mapped->Metadata().name.empty());
+    auto copied = mapped->toSpectrum();
+    assert(copied.HermitianCount() == 16 && copied.Values() == values);
+    std::filesystem::remove(path);
+}
+
+void test_invalid_file() {
+    std::cout << "Reject invalid files" << std::endl;
+    std::string path = temp_path("soil_test_invalid.bin");
+    assert(!loadWavement(path));
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "SOILDATA but truncated";
+    }
+    assert(!loadWavement(path));
+
+    Wavement w(Sequence::LinSpaced(100, 0.0, 1.0));
+    w.setValues("amp", Sequence::Ones(100));
+    assert(saveWavement(path, w));
+    std::filesystem::resize_file(path, 512);
+    assert(!loadWavement(path));
+    std::filesystem::remove(path);
+}
+
+int main() {
+    std::cout << "Test of storage" << std::endl;
+    test_wavement_file();
+    std::cout << std::endl;
+    test_spectrum_file();
+    std::cout << std::endl;
+    test_invalid_file();
+    return 0;
+}
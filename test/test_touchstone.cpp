@@ -0,0 +1,99 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "soil/signal/touchstone.hpp"
+
+using namespace soil::signal;
+
+std::string temp_path(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void write_file(const std::string &path, const std::string &content) {
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+}
+
+void test_one_port() {
+    std::cout << "Read 1-port file on non-uniform grid" << std::endl;
+    std::string path = temp_path("soil_test_one.s1p");
+    write_file(path, "! measured reflection\n"
+                     "# MHz S RI R 75\n"
+                     "1.0 0.5 -0.5\n"
+                     "2.0 0.25 0.0 ! inline comment\r\n"
+                     "4.0 +1.0E-01 0.1\n"
+                     "5.0 0.0 0.0\n");
+    auto data = readTouchstone(path);
+    assert(data.has_value() && data->ports == 1 && data->parameter == 'S');
+    assert(data->resistance == 75.0 && data->frequencies.size() == 4);
+    assert(data->frequencies[2] == 4e6);
+    assert(data->Parameter(1, 1)[2] == std::complex<double>(0.1, 0.1));
+    assert(data->Parameter(2, 1).size() == 0);
+
+    // resampled onto step of 1MHz, 3MHz is interpolated
+    assert(loadTouchstone(path));
+    auto measured = loadTouchstone(path, 1, 1, 1e6);
+    assert(measured);
+    Spectrum spec(1e6, 1e6, Characteristics::Ones(5));
+    auto tuned = measured->tune(spec);
+    assert(std::abs(tuned.Values()[2] - std::complex<double>(0.175, 0.05)) <
+           1e-12);
+    assert(!loadTouchstone(path, 1, 2));
+    std::filesystem::remove(path);
+}
+
+void test_two_port() {
+    std::cout << "Read 2-port file in DB format" << std::endl;
+    std::string path = temp_path("soil_test_two.S2P");
+    std::string content = "# GHz S DB\n";
+    for (int i = 0; i < 5; ++i) {
+        content += std::to_string(1.0 + 0.5 * i) + " -20 0 -3 " +
+                   std::to_string(-10.0 * i) + "\n  -40 0 -20 90\n";
+    }
+    write_file(path, content);
+    auto data = readTouchstone(path);
+    assert(data.has_value() && data->ports == 2 && data->resistance == 50.0);
+    auto s21 = data->Parameter(2, 1), s12 = data->Parameter(1, 2);
+    assert(std::abs(std::abs(s21[0]) - std::pow(10.0, -3.0 / 20.0)) < 1e-12);
+    assert(std::abs(std::abs(s12[0]) - 0.01) < 1e-12);
+    assert(std::abs(std::arg(s21[3]) + M_PI / 6.0) < 1e-12);
+    assert(std::abs(std::arg(data->Parameter(2, 2)[0]) - M_PI / 2.0) < 1e-12);
+
+    // uniform grid is taken as is
+    auto measured = loadTouchstone(path, 2, 1);
+    assert(measured);
+    Spectrum spec(1e9, 5e8, Characteristics::Ones(5));
+    assert((measured->tune(spec).Values() - s21).cwiseAbs().maxCoeff() <
+           1e-12);
+
+    // noise parameters, 5 numbers per frequency, are ignored
+    write_file(path, content + "! noise parameters\n"
+                               "1.0 2.5 0.6 45 0.3\n2.0 2.8 0.5 60 0.35\n");
+    auto noisy = readTouchstone(path);
+    assert(noisy.has_value() && noisy->frequencies == data->frequencies);
+    assert(noisy->parameters == data->parameters);
+
+    // malformed or incomplete files
+    write_file(path, "# GHz S MA\n1.0 0.5 0 0.5 0 0.5 0 0.5 zero\n");
+    assert(!readTouchstone(path).has_value());
+    write_file(path, "# GHz S MA\n1.0 0.5 0 0.5 0\n");
+    assert(!readTouchstone(path).has_value());
+    write_file(path, "# GHz S XY\n1.0 0.5 0 0.5 0 0.5 0 0.5 0\n");
+    assert(!readTouchstone(path).has_value());
+    std::filesystem::remove(path);
+    assert(!readTouchstone(temp_path("soil_test_none.txt"), 1).has_value());
+    assert(!readTouchstone(temp_path("soil_test_two.dat")).has_value());
+}
+
+int main() {
+    std::cout << "Test of Touchstone files" << std::endl;
+    test_one_port();
+    std::cout << std::endl;
+    test_two_port();
+    return 0;
+}
@@ -0,0 +1,342 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <complex>
+#include <iostream>
+#include <math.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "soil/signal/signal.hpp"
+#include "soil/signal/tuner.hpp"
+
+using namespace soil::signal;
+
+/** response with gain 1 below `cutoff` and 0 above, from 0 to 1000Hz */
+Tuner_ptr make_lowpass(double cutoff) {
+    Characteristics ch(1001);
+    for (Index i = 0; i < ch.size(); ++i) {
+        ch[i] = (double(i) < cutoff) ? 1.0 : 0.0;
+    }
+    return std::make_shared<MeasuredSParameter>(0.0, 1.0, ch);
+}
+
+double rms(const Sequence &values) {
+    return sqrt(values.squaredNorm() / double(values.size()));
+}
+
+void test_tuner_channel() {
+    std::cout << "Tune sine wavement by measured S-parameter" << std::endl;
+    TunerChannel channel(make_lowpass(100.0));
+    Sequence ts = Sequence::LinSpaced(1000, 0.0, 0.999);
+    auto pass = channel.via(SineSignal(50.0).get(ts));
+    auto stop = channel.via(SineSignal(200.0).get(ts));
+    std::cout << "  - rms of 50Hz: " << rms(pass.Values("amp"))
+              << ", rms of 200Hz: " << rms(stop.Values("amp")) << std::endl;
+    assert(pass.Referee() == ts);
+    assert(fabs(rms(pass.Values("amp")) - sqrt(0.5)) < 1e-9);
+    assert(rms(stop.Values("amp")) < 1e-9);
+}
+
+/** tuner rebuilding its output from frequencies and values */
+class Rebuilder : public Tuner {
+public:
+    explicit Rebuilder(Size keep) : Tuner("rebuilder"), keep(keep) {}
+    Spectrum tune(const Spectrum &spec) const {
+        return Spectrum(Sequence(spec.Frenquencies().head(keep)),
+                        Characteristics(2.0 * spec.Values().head(keep)));
+    }
+
+private:
+    Size keep;
+};
+
+void test_rebuilt_spectrum() {
+    std::cout << "Tune by a spectrum without Hermitian count" << std::endl;
+    Sequence ts = Sequence::LinSpaced(1000, 0.0, 0.999);
+    auto input = SineSignal(50.0).get(ts);
+    TunerChannel channel(std::make_shared<Rebuilder>(501));
+    auto post = channel.via(input);
+    assert((post.Values("amp") - 2.0 * input.Values("amp"))
+               .cwiseAbs()
+               .maxCoeff() < 1e-12);
+
+    // mismatched output is an error, not a silent pass-through
+    channel.setTuner(std::make_shared<Rebuilder>(400));
+    bool thrown = false;
+    try {
+        channel.via(input);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_streaming_channel() {
+    std::cout << "Stream blocks through measured S-parameter" << std::endl;
+    double dt = 1e-3;
+    Size block = 256, taps = 128;
+    auto lowpass = make_lowpass(100.0);
+    StreamingTunerChannel channel(lowpass, dt, block, taps);
+    assert(channel.Latency() == taps / 2);
+
+    // constant complex gain is a pure delay of latency
+    Characteristics gain = Characteristics::Constant(2001, {0.0, 0.5});
+    StreamingTunerChannel delay(
+        std::make_shared<MeasuredSParameter>(-1000.0, 1.0, gain), dt, block,
+        taps);
+    Size n = 3000;
+    Sequence ts = Sequence::LinSpaced(n, 0.0, double(n - 1) * dt);
+    auto input = ComplexSineSignal(30.0).get(ts);
+    Sequence real = Sequence::Zero(n), imag = Sequence::Zero(n);
+    for (Index pos = 0; pos < n; pos += 100) {
+        Size len = std::min(Size(100), n - pos);
+        Wavement part(ts.segment(pos, len));
+        part.setValues("real", input.Values("real").segment(pos, len));
+        part.setValues("imag", input.Values("imag").segment(pos, len));
+        auto out = delay.feed(part);
+        assert(out.PointCount() == len);
+        real.segment(pos, len) = out.Values("real");
+        imag.segment(pos, len) = out.Values("imag");
+    }
+    Size lat = delay.Latency();
+    double err =
+        (real.tail(n - lat) + 0.5 * input.Values("imag").head(n - lat))
+            .cwiseAbs()
+            .maxCoeff();
+    err = std::max(err, (imag.tail(n - lat) -
+                         0.5 * input.Values("real").head(n - lat))
+                            .cwiseAbs()
+                            .maxCoeff());
+    std::cout << "  - error of delayed complex stream " << err << std::endl;
+    assert(err < 1e-9);
+
+    // one-shot processing compensates latency
+    auto aligned = delay.via(input);
+    err = (aligned.Values("imag") - 0.5 * input.Values("real"))
+              .cwiseAbs()
+              .maxCoeff();
+    std::cout << "  - error of aligned complex wavement " << err << std::endl;
+    assert(err < 1e-9);
+
+    // missing real part is zero, other columns are kept
+    Wavement quadrature(ts);
+    quadrature.setValues("imag", input.Values("imag"));
+    quadrature.setValues("env", Sequence::Ones(n));
+    auto rotated = delay.via(quadrature);
+    assert((rotated.Keys() ==
+            std::vector<std::string>{"real", "imag", "env"}));
+    assert(rotated.Values("env").size() == n);
+    err = (rotated.Values("real") + 0.5 * input.Values("imag"))
+              .cwiseAbs()
+              .maxCoeff();
+    assert(err < 1e-9 && rotated.Values("imag").cwiseAbs().maxCoeff() < 1e-9);
+
+    // low pass filtering keeps 50Hz and rejects 200Hz in steady state
+    auto pass = channel.via(SineSignal(50.0).get(ts));
+    auto stop = channel.via(SineSignal(200.0).get(ts));
+    double pass_rms = rms(pass.Values("amp").segment(taps, n - 2 * taps));
+    double stop_rms = rms(stop.Values("amp").segment(taps, n - 2 * taps));
+    std::cout << "  - rms of 50Hz: " << pass_rms << ", rms of 200Hz: "
+              << stop_rms << std::endl;
+    assert(fabs(pass_rms - sqrt(0.5)) < 0.05);
+    assert(stop_rms < 0.05);
+
+    // feeding blocks equals one-shot processing delayed by latency
+    channel.reset();
+    auto sine = SineSignal(50.0).get(ts);
+    Sequence fed(n);
+    for (Index pos = 0; pos < n; pos += 700) {
+        Size len = std::min(Size(700), n - pos);
+        Wavement part(ts.segment(pos, len));
+        part.setValues("amp", sine.Values("amp").segment(pos, len));
+        fed.segment(pos, len) = channel.feed(part).Values("amp");
+    }
+    err = (fed.tail(n - lat) - pass.Values("amp").head(n - lat))
+              .cwiseAbs()
+              .maxCoeff();
+    std::cout << "  - error of fed real stream " << err << std::endl;
+    assert(err < 1e-9);
+}
+
+/** tuner scaling every bin by its "gain" parameter */
+class Scaler : public Tuner {
+public:
+    Scaler() : Tuner("scaler"), gain_id(prepareParameter("gain", 1.0)) {}
+    Spectrum tune(const Spectrum &spec) const {
+        Spectrum tuned(spec);
+        tuned.MutableValues() *= ParameterAs(gain_id);
+        return tuned;
+    }
+
+    soil::util::ParamId<double> gain_id;
+};
+
+void test_streaming_change() {
+    std::cout << "Change tuner parameters mid-stream" << std::endl;
+    double dt = 1e-3;
+    auto scaler = std::make_shared<Scaler>();
+    StreamingTunerChannel channel(scaler, dt, 256, 64);
+    Size n = 2000, change = 1000, lat = channel.Latency();
+    Sequence ts = Sequence::LinSpaced(n, 0.0, double(n - 1) * dt);
+    auto input = SineSignal(20.0).get(ts);
+    const Sequence &x = input.ValuesRef("amp");
+    Sequence fed(n);
+    for (Index pos = 0; pos < n; pos += 250) {
+        if (pos == change) {
+            scaler->setParameter(scaler->gain_id, 3.0);
+        }
+        Wavement part(ts.segment(pos, 250));
+        part.setValues("amp", x.segment(pos, 250));
+        fed.segment(pos, 250) = channel.feed(part).Values("amp");
+    }
+    // constant gain is a pure delay, scaled from the block after the change
+    double err = (fed.segment(lat, change - lat) - x.head(change - lat))
+                     .cwiseAbs()
+                     .maxCoeff();
+    err = std::max(err, (fed.tail(n - change) -
+                         3.0 * x.segment(change - lat, n - change))
+                            .cwiseAbs()
+                            .maxCoeff());
+    std::cout << "  - error of stream across the change " << err << std::endl;
+    assert(err < 1e-9);
+
+    // one-shot processing uses the current gain as well
+    auto aligned = channel.via(input);
+    assert((aligned.Values("amp") - 3.0 * x).cwiseAbs().maxCoeff() < 1e-9);
+}
+
+void test_spectrum_grid() {
+    std::cout << "Tune spectra on uniform and explicit axes" << std::endl;
+    Characteristics ch(50);
+    for (Index i = 0; i < ch.size(); ++i) {
+        ch[i] = std::complex<double>(1.0 + 0.1 * double(i), -0.2);
+    }
+    MeasuredSParameter measured(10.0, 0.5, ch);
+    Characteristics values = Characteristics::Constant(80, {2.0, 1.0});
+    Spectrum uniform(5.0, 0.5, values);
+    assert(uniform.Grid().has_value() && uniform.FrequencyAt(12) == 11.0);
+    assert(uniform.NearestIndex(11.1) == 12);
+
+    // aligned grid takes the offset path, explicit axis is tuned bin by bin
+    Sequence freq = uniform.Frenquencies();
+    freq[79] += 1e-3;
+    Spectrum irregular(freq, values);
+    assert(!irregular.Grid().has_value());
+    auto fast = measured.tune(uniform);
+    auto slow = measured.tune(irregular);
+    assert(fast.Grid().has_value());
+    assert((fast.Values() - slow.Values()).cwiseAbs().maxCoeff() < 1e-15);
+    assert(fast.Values()[9] == values[9]);
+    assert(fast.Values()[10] == values[10] * ch[0]);
+    assert(fast.Values()[59] == values[59] * ch[49]);
+    assert(fast.Values()[60] == values[60]);
+}
+
+void test_interpolation() {
+    std::cout << "Interpolate measured characteristics" << std::endl;
+    Characteristics ch(20);
+    for (Index i = 0; i < ch.size(); ++i) {
+        double x = double(i);
+        ch[i] = std::polar(1.0 + 0.1 * x, 0.3 * x) + 0.01 * x * x;
+    }
+    Characteristics rotation(20);
+    for (Index i = 0; i < ch.size(); ++i) {
+        rotation[i] = std::polar(1.0 + 0.1 * double(i), 0.5 * double(i));
+    }
+    MeasuredSParameter measured(0.0, 1.0, ch, "linear");
+    assert(!measured.setParameter("interpolation", std::string("spline")));
+    assert(!measured.setParameter("interpolation", 1));
+
+    // spectrum on half steps, second half out of measured range
+    Characteristics ones = Characteristics::Ones(60);
+    Spectrum half(0.0, 0.5, ones);
+    auto linear = measured.tune(half);
+    assert(std::abs(linear.Values()[7] - 0.5 * (ch[3] + ch[4])) < 1e-12);
+    assert(linear.Values()[50] == 1.0);
+    assert(measured.tune(half).Values() == linear.Values());
+
+    // quadratic part is exact with cubic interpolation
+    Characteristics quadratic(20);
+    for (Index i = 0; i < quadratic.size(); ++i) {
+        quadratic[i] = std::complex<double>(double(i * i), -double(i));
+    }
+    MeasuredSParameter cubic(0.0, 1.0, quadratic, "cubic");
+    auto tuned = cubic.tune(half);
+    for (Index i = 2; i < 36; ++i) {
+        double x = 0.5 * double(i);
+        assert(std::abs(tuned.Values()[i] - std::complex<double>(x * x, -x)) <
+               1e-12);
+    }
+
+    // magnitude and phase are interpolated separately in polar mode
+    MeasuredSParameter polar(0.0, 1.0, rotation, "linear", true);
+    auto rotated = polar.tune(half);
+    assert(std::abs(rotated.Values()[7] - std::polar(1.35, 1.75)) < 1e-12);
+    assert(polar.setParameter("polar", false));
+    assert(std::abs(polar.tune(half).Values()[7] - std::polar(1.35, 1.75)) >
+           1e-3);
+}
+
+/** tuner doubling every bin, using default response */
+class Doubler : public Tuner {
+public:
+    Doubler() : Tuner("doubler") {}
+    Spectrum tune(const Spectrum &spec) const {
+        Spectrum tuned(spec);
+        tuned.MutableValues() *= 2.0;
+        return tuned;
+    }
+};
+
+void test_cascade() {
+    std::cout << "Fold responses of cascaded tuners" << std::endl;
+    Characteristics cable(100), filter(100);
+    for (Index i = 0; i < 100; ++i) {
+        cable[i] = std::polar(1.0 - 0.002 * double(i), -0.05 * double(i));
+        filter[i] = (i < 60) ? 1.0 : 0.1;
+    }
+    auto first = std::make_shared<MeasuredSParameter>(0.0, 10.0, cable,
+                                                      "linear");
+    auto second = std::make_shared<MeasuredSParameter>(5.0, 10.0, filter);
+    TunerCascade cascade({first, nullptr, second});
+    cascade.append(std::make_shared<Doubler>());
+    assert(cascade.Tuners().size() == 3);
+
+    Characteristics values(256);
+    for (Index i = 0; i < values.size(); ++i) {
+        values[i] = std::complex<double>(std::cos(0.1 * double(i)), 0.5);
+    }
+    Spectrum spec(-20.0, 4.0, values);
+    auto expected = Doubler().tune(second->tune(first->tune(spec)));
+    auto tuned = cascade.tune(spec);
+    assert((tuned.Values() - expected.Values()).cwiseAbs().maxCoeff() <
+           1e-12);
+    assert(cascade.tune(spec).Values() == tuned.Values());
+
+    // changing a stage folds responses again
+    first->setParameter("interpolation", std::string("nearest"));
+    expected = Doubler().tune(second->tune(first->tune(spec)));
+    tuned = cascade.tune(spec);
+    assert((tuned.Values() - expected.Values()).cwiseAbs().maxCoeff() <
+           1e-12);
+}
+
+int main() {
+    std::cout << "Test of tuners" << std::endl;
+    test_tuner_channel();
+    std::cout << std::endl;
+    test_rebuilt_spectrum();
+    std::cout << std::endl;
+    test_streaming_channel();
+    std::cout << std::endl;
+    test_streaming_change();
+    std::cout << std::endl;
+    test_spectrum_grid();
+    std::cout << std::endl;
+    test_interpolation();
+    std::cout << std::endl;
+    test_cascade();
+    return 0;
+}
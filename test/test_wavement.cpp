@@ -0,0 +1,163 @@
+#define _USE_MATH_DEFINES
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "soil/signal/convert.hpp"
+#include "soil/signal/processor.hpp"
+#include "soil/signal/signal.hpp"
+#include "soil/signal/wavement.hpp"
+#include "soil/signal/wavement_view.hpp"
+
+using namespace soil::signal;
+
+void test_columns() {
+    std::cout << "Store columns contiguously" << std::endl;
+    Sequence ts = Sequence::LinSpaced(5, 0.0, 0.4);
+    Wavement w(ts);
+    w.setValues("a", Sequence::Constant(5, 1.0));
+    w.setValues("b", Sequence::LinSpaced(5, 0.0, 4.0));
+    w.setValues("c", Sequence::Constant(5, 3.0));
+    w.setValues("b", Sequence::Zero(5)); // duplicated key is ignored
+    w.setValues("d", Sequence::Zero(4)); // mismatched size is ignored
+    assert(w.ValueCount() == 3);
+    assert((w.Keys() == std::vector<std::string>{"a", "b", "c"}));
+    assert(w.KeyIndex("b") == 1 && w.KeyIndex("d") == -1);
+    assert(w.Values("d").size() == 0 && w.Values(Index(7)).size() == 0);
+
+    auto m = w.ValueMatrix();
+    assert(m.rows() == 5 && m.cols() == 3);
+    assert(m(2, 1) == 2.0 && m(4, 2) == 3.0);
+    assert(w.ValuesRef(Index(1)).data() == m.col(1).data());
+    std::cout << "Matrix of values:" << std::endl << m << std::endl;
+
+    auto p = w.PointAt(3);
+    assert(p.has_value());
+    assert(p->referee == ts[3] && p->values["b"] == 3.0);
+    assert(!w.PointAt(5).has_value());
+
+    Wavement copied(w);
+    w.setReferee(ts);
+    assert(w.ValueCount() == 0 && copied.ValueCount() == 3);
+    assert(copied.Values("c") == Sequence::Constant(5, 3.0));
+
+    Wavement reserved(ts);
+    reserved.reserveValues(2);
+    reserved.setValues("x", Sequence::Ones(5));
+    auto data = reserved.ValuesRef("x").data();
+    reserved.setValues("y", Sequence::Ones(5));
+    assert(reserved.ValuesRef("x").data() == data);
+
+    // capacity grows geometrically, references held across additions
+    // within it stay valid
+    Wavement grown(ts);
+    for (const auto &key : {"a", "b", "c"}) {
+        grown.setValues(key, Sequence::Constant(5, 7.0));
+    }
+    ConstSequenceRef held = grown.ValuesRef("a");
+    grown.setValues("d", Sequence::Zero(5));
+    assert(held.data() == grown.ValuesRef("a").data());
+    assert(held == Sequence::Constant(5, 7.0));
+
+    // copied values are kept when the matrix grows
+    auto kept = grown.Values("a");
+    for (const auto &key : {"e", "f", "g", "h", "i"}) {
+        grown.setValues(key, Sequence::Zero(5));
+    }
+    assert(grown.ValuesRef("a").data() != held.data());
+    assert(kept == Sequence::Constant(5, 7.0));
+}
+
+void test_view() {
+    std::cout << "View interleaved buffer without copy" << std::endl;
+    // interleaved frames of (time, a, b)
+    Size n = 8;
+    std::vector<double> buffer(3 * n);
+    for (Size i = 0; i < n; ++i) {
+        buffer[3 * i] = 0.125 * double(i);
+        buffer[3 * i + 1] = cos(2 * M_PI * double(i) / double(n));
+        buffer[3 * i + 2] = double(i);
+    }
+    WavementView view(buffer.data(), n, 3);
+    assert(view.addValues("a", buffer.data() + 1, 3));
+    assert(view.addValues("b", buffer.data() + 2, 3));
+    assert(!view.addValues("a", buffer.data() + 2, 3));
+    assert(view.PointCount() == n && view.ValueCount() == 2);
+    assert(view.Values("b").data() == buffer.data() + 2);
+    assert(view.Values("b")[5] == 5.0 && view.Referee()[2] == 0.25);
+    assert(view.Values("c").size() == 0);
+
+    auto w = view.toWavement();
+    assert(w.ValueCount() == 2 && w.Values("b")[7] == 7.0);
+    WavementView back(w);
+    assert(back.Values(Index(0)).data() == w.ValuesRef("a").data());
+
+    LinearChannel channel(1.0, 2.0, 0.5);
+    auto post = channel.viaView(view);
+    auto expected = channel.via(w);
+    assert(post.Referee() == expected.Referee());
+    assert(post.Values("b") == expected.Values("b"));
+    assert(post.Values("a")[0] == 2.5 && post.Referee()[0] == 1.0);
+
+    WavementView single(buffer.data(), n, 3);
+    single.addValues("amp", buffer.data() + 1, 3);
+    auto spec = wavementToSpectrum(single);
+    assert(spec.has_value() && spec->HermitianCount() == n);
+    assert(std::abs(spec->Values()[1] - 0.5 * double(n)) < 1e-12);
+
+    // signals generate on referee of a view, values are ignored
+    auto generated = SineSignal(2.0).getOn(view);
+    assert(generated.Referee() == view.Referee());
+    assert(generated.Values("amp") ==
+           SineSignal(2.0).get(Sequence(view.Referee())).Values("amp"));
+}
+
+void test_uniform() {
+    std::cout << "Hold uniform referee implicitly" << std::endl;
+    Sequence ts = Sequence::LinSpaced(1001, -0.3, 0.7);
+    Wavement w(ts);
+    auto grid = w.Grid();
+    assert(grid.has_value() && grid->count == 1001 && grid->start == -0.3);
+    assert(std::abs(grid->step - 1e-3) < 1e-15);
+    for (Index i = 0; i < ts.size(); ++i) {
+        assert(w.RefereeAt(i) == ts[i]);
+    }
+    assert(std::isnan(w.RefereeAt(1001)));
+    assert(w.NearestIndex(0.0004) == 300 && w.NearestIndex(-5.0) == 0);
+    assert(w.NearestIndex(5.0) == 1000);
+    assert(w.Referee() == ts);
+
+    // copy, shift and conversion keep it implicit
+    w.setValues("amp", Sequence(ts.array().sin()));
+    Wavement copied(w);
+    assert(copied.Grid().has_value() && copied.Referee() == ts);
+    LinearChannel(0.3).process(copied);
+    assert(copied.Grid().has_value() && copied.RefereeAt(0) == 0.0);
+    assert(copied.Values("amp") == w.Values("amp"));
+    auto spec = wavementToSpectrum(Wavement(UniformGrid{0.0, 0.5, 8}));
+    assert(!spec.has_value());
+    Wavement sampled(UniformGrid{0.0, 0.5, 8});
+    sampled.setValues("amp", Sequence::Ones(8));
+    spec = wavementToSpectrum(sampled);
+    assert(spec.has_value() && spec->Values()[0] == 8.0);
+    assert(spectrumToWavement(spec.value())->Grid().has_value());
+
+    // irregular or modified referee is explicit
+    Sequence irregular = ts;
+    irregular[5] += 1e-9;
+    Wavement other(irregular);
+    assert(!other.Grid().has_value() && other.NearestIndex(0.0004) == 300);
+    w.MutableReferee()[0] = -1.0;
+    assert(!w.Grid().has_value() && w.RefereeAt(0) == -1.0);
+}
+
+int main() {
+    std::cout << "Test of wavement" << std::endl;
+    test_columns();
+    std::cout << std::endl;
+    test_view();
+    std::cout << std::endl;
+    test_uniform();
+    return 0;
+}